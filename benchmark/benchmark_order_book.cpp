@@ -0,0 +1,433 @@
+/// \file   benchmark_order_book.cpp
+///
+/// \brief  Compares the order book implementations on synthetic order flows.
+///
+/// \details    Every flow is generated once, up front, and replayed against a
+///             fresh book of each type. A flow is replayed twice: once
+///             without timing individual operations to measure throughput,
+///             and once timing every operation to measure latency.
+///
+///             usage:
+///                 benchmark_order_book [--orders n] [--flow name]
+///                                      [--book name] [--seed n] [--histogram]
+///
+///             flows:  passive, sweep, cancel_replace, deep, thin
+///             books:  static, static_tick, paged, binary_tree
+///
+/// \authors    Maarten P. Scholl
+/// \date       2026-10-17
+/// \copyright  Copyright 2017-2026 The Institute for New Economic Thinking,
+///             Oxford Martin School, University of Oxford
+///
+///             Licensed under the Apache License, Version 2.0 (the "License");
+///             you may not use this file except in compliance with the License.
+///             You may obtain a copy of the License at
+///
+///                 http://www.apache.org/licenses/LICENSE-2.0
+///
+///             Unless required by applicable law or agreed to in writing,
+///             software distributed under the License is distributed on an "AS
+///             IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+///             express or implied. See the License for the specific language
+///             governing permissions and limitations under the License.
+///
+///             You may obtain instructions to fulfill the attribution
+///             requirements in CITATION.cff
+///
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <esl/economics/currencies.hpp>
+#include <esl/economics/markets/order_book/binary_tree_order_book.hpp>
+#include <esl/economics/markets/order_book/paged_order_book.hpp>
+#include <esl/economics/markets/order_book/report_sink.hpp>
+#include <esl/economics/markets/order_book/static_order_book.hpp>
+
+using namespace esl;
+using namespace esl::economics;
+using namespace esl::economics::markets;
+using namespace esl::economics::markets::order_book;
+
+
+// all books accept prices between 80.00 and 120.00, the flows are centred
+// on 100.00, with a tick size of one cent
+constexpr std::int64_t minimum_price = 80'00;
+constexpr std::int64_t maximum_price = 120'00;
+constexpr std::int64_t mid_price = 100'00;
+constexpr std::uint64_t lot_size = 100;
+
+///
+/// \brief  An insertion, or the cancellation of the order placed by an
+///         earlier insertion
+///
+struct operation
+{
+    limit_order order;
+
+    ///
+    /// \brief  For cancellations, the position of the insertion in the flow
+    ///
+    std::size_t target;
+
+    bool cancel;
+};
+
+struct flow
+{
+    std::string name;
+
+    std::vector<operation> operations = {};
+
+    ///
+    /// \brief  Number of leading operations that build up the book, which
+    ///         are excluded from the measurements
+    ///
+    std::size_t prefill = 0;
+};
+
+///
+/// \brief  Remembers the identifier of the last order placed, and counts
+///         reports without storing them.
+///
+struct placement_sink
+: public counting_report_sink
+{
+    basic_book::order_identifier placed = basic_book::direct_order;
+
+    void consume( execution_report::state_t state
+                , limit_order::side_t side
+                , std::uint32_t quantity
+                , std::uint64_t identifier
+                , const quote &limit
+                , const identity<agent> &owner
+                ) override
+    {
+        if(execution_report::placement == state){
+            placed = identifier;
+        }
+        counting_report_sink::consume(state, side, quantity, identifier, limit, owner);
+    }
+};
+
+limit_order create(std::int64_t cents, std::uint32_t quantity, limit_order::side_t side)
+{
+    return limit_order( ticker()
+                      , identity<agent>()
+                      , side
+                      , quote(price(cents, currencies::USD), lot_size * currencies::USD.denominator)
+                      , quantity
+                      , limit_order::lifetime_t::good_until_cancelled
+                      );
+}
+
+///
+/// \brief  A non-crossing order within `width` ticks of the mid price
+///
+limit_order passive(std::minstd_rand &generator, std::int64_t width)
+{
+    std::uniform_int_distribution<std::int64_t> offset_(1, width);
+    std::uniform_int_distribution<std::uint32_t> quantity_(1, 100);
+    if(generator() & 0x1){
+        return create(mid_price - offset_(generator), quantity_(generator), limit_order::buy);
+    }
+    return create(mid_price + offset_(generator), quantity_(generator), limit_order::sell);
+}
+
+///
+/// \brief  Only passive orders, so that the book grows without matching
+///
+flow passive_flow(std::size_t orders, std::minstd_rand &generator)
+{
+    flow result_ {"passive"};
+    for(std::size_t i = 0; i < orders; ++i){
+        result_.operations.push_back({passive(generator, 100), 0, false});
+    }
+    return result_;
+}
+
+///
+/// \brief  Passive orders interleaved with large orders that cross the
+///         whole band on the other side, sweeping many price levels
+///
+flow sweep_flow(std::size_t orders, std::minstd_rand &generator)
+{
+    flow result_ {"sweep"};
+    constexpr std::int64_t width_ = 20;
+    std::uniform_int_distribution<std::uint32_t> sweep_(500, 2000);
+    for(std::size_t i = 0; i < orders; ++i){
+        if(0 == i % 10){
+            if(generator() & 0x1){
+                result_.operations.push_back({create(mid_price + width_, sweep_(generator), limit_order::buy), 0, false});
+            }else{
+                result_.operations.push_back({create(mid_price - width_, sweep_(generator), limit_order::sell), 0, false});
+            }
+        }else{
+            result_.operations.push_back({passive(generator, width_), 0, false});
+        }
+    }
+    return result_;
+}
+
+///
+/// \brief  Keeps a fixed number of passive orders in the book, and replaces
+///         a random one with every pair of operations
+///
+flow cancel_replace_flow(std::size_t orders, std::minstd_rand &generator)
+{
+    flow result_ {"cancel_replace"};
+    const std::size_t resting_ = std::max<std::size_t>(1, std::min<std::size_t>(orders / 10, 10'000));
+
+    // the position in the flow of the insertion of each live order
+    std::vector<std::size_t> live_;
+    for(std::size_t i = 0; i < resting_; ++i){
+        live_.push_back(result_.operations.size());
+        result_.operations.push_back({passive(generator, 50), 0, false});
+    }
+    result_.prefill = result_.operations.size();
+
+    std::uniform_int_distribution<std::size_t> victim_(0, resting_ - 1);
+    for(std::size_t i = 0; i < orders / 2; ++i){
+        auto &slot_ = live_[victim_(generator)];
+        result_.operations.push_back({limit_order(), slot_, true});
+        slot_ = result_.operations.size();
+        result_.operations.push_back({passive(generator, 50), 0, false});
+    }
+    return result_;
+}
+
+///
+/// \brief  Orders are normally distributed around the mid price, they are
+///         crossing as often as not, and one in five operations is a
+///         cancellation of an earlier order that may have been filled.
+///
+/// \param width    standard deviation in ticks, small values concentrate
+///                 many orders on few price levels
+///
+flow mixed_flow(std::string name, std::size_t orders, std::minstd_rand &generator, double width)
+{
+    flow result_ {std::move(name)};
+    std::normal_distribution<> limit_(double(mid_price), width);
+    std::uniform_int_distribution<std::uint32_t> quantity_(1, 100);
+    std::vector<std::size_t> inserted_;
+    for(std::size_t i = 0; i < orders; ++i){
+        if(!inserted_.empty() && 0 == generator() % 5){
+            std::uniform_int_distribution<std::size_t> target_(0, inserted_.size() - 1);
+            result_.operations.push_back({limit_order(), inserted_[target_(generator)], true});
+            continue;
+        }
+        auto cents_ = std::clamp(std::int64_t(limit_(generator)), minimum_price + 1, maximum_price - 1);
+        auto side_ = (generator() & 0x1) ? limit_order::buy : limit_order::sell;
+        inserted_.push_back(result_.operations.size());
+        result_.operations.push_back({create(cents_, quantity_(generator), side_), 0, false});
+    }
+    return result_;
+}
+
+struct book_type
+{
+    std::string name;
+
+    std::function<std::unique_ptr<basic_book>(std::uint32_t)> create;
+};
+
+std::vector<book_type> book_types()
+{
+    auto minimum_ = quote(price(minimum_price, currencies::USD), lot_size * currencies::USD.denominator);
+    auto maximum_ = quote(price(maximum_price, currencies::USD), lot_size * currencies::USD.denominator);
+    return
+        { {"static", [=](std::uint32_t capacity) -> std::unique_ptr<basic_book>
+            { return std::make_unique<static_order_book>(minimum_, maximum_, capacity); }}
+        , {"static_tick", [=](std::uint32_t capacity) -> std::unique_ptr<basic_book>
+            { return std::make_unique<basic_static_order_book<tick_price_codec>>(minimum_, maximum_, capacity); }}
+        , {"paged", [=](std::uint32_t capacity) -> std::unique_ptr<basic_book>
+            { return std::make_unique<paged_order_book>(minimum_, maximum_, capacity); }}
+        , {"binary_tree", [](std::uint32_t) -> std::unique_ptr<basic_book>
+            { return std::make_unique<binary_tree_order_book>(); }}
+        };
+}
+
+///
+/// \brief  Performs the operations in [first, last), `identifiers` maps
+///         positions in the flow to the identifier the book assigned
+///
+template<bool timed_>
+void replay( basic_book &book
+           , placement_sink &sink
+           , const flow &f
+           , std::size_t first
+           , std::size_t last
+           , std::vector<basic_book::order_identifier> &identifiers
+           , std::vector<std::uint64_t> &latencies
+           )
+{
+    for(std::size_t i = first; i < last; ++i){
+        const auto &o = f.operations[i];
+        std::chrono::steady_clock::time_point start_;
+        if constexpr(timed_){
+            start_ = std::chrono::steady_clock::now();
+        }
+        if(o.cancel){
+            auto identifier_ = identifiers[o.target];
+            if(basic_book::direct_order != identifier_){
+                book.cancel(identifier_);
+            }
+        }else{
+            sink.placed = basic_book::direct_order;
+            book.insert(o.order);
+            identifiers[i] = sink.placed;
+        }
+        if constexpr(timed_){
+            auto elapsed_ = std::chrono::steady_clock::now() - start_;
+            latencies.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed_).count());
+        }
+    }
+}
+
+///
+/// \brief  Runs the flow on a fresh book, returns the reports generated
+///
+template<bool timed_>
+placement_sink run( const book_type &type
+                  , const flow &f
+                  , double &seconds
+                  , std::vector<std::uint64_t> &latencies
+                  )
+{
+    auto book_ = type.create(static_cast<std::uint32_t>(f.operations.size() + 1));
+    auto sink_ = std::make_shared<placement_sink>();
+    book_->sink = sink_;
+
+    std::vector<basic_book::order_identifier> identifiers_(f.operations.size(), basic_book::direct_order);
+    replay<false>(*book_, *sink_, f, 0, f.prefill, identifiers_, latencies);
+
+    latencies.clear();
+    latencies.reserve(f.operations.size() - f.prefill);
+    auto start_ = std::chrono::steady_clock::now();
+    replay<timed_>(*book_, *sink_, f, f.prefill, f.operations.size(), identifiers_, latencies);
+    auto elapsed_ = std::chrono::steady_clock::now() - start_;
+    seconds = std::chrono::duration<double>(elapsed_).count();
+    return *sink_;
+}
+
+///
+/// \brief  The smallest latency such that a fraction `p` of the sorted
+///         latencies is at most that value
+///
+std::uint64_t percentile(const std::vector<std::uint64_t> &sorted, double p)
+{
+    if(sorted.empty()){
+        return 0;
+    }
+    auto rank_ = static_cast<std::size_t>(std::ceil(p * sorted.size()));
+    return sorted[std::clamp<std::size_t>(rank_, 1, sorted.size()) - 1];
+}
+
+///
+/// \brief  Prints the number of operations per power-of-two latency bucket
+///
+void print_histogram(const std::vector<std::uint64_t> &sorted)
+{
+    std::uint64_t upper_ = 1;
+    auto i = sorted.begin();
+    while(i != sorted.end()){
+        auto j = std::upper_bound(i, sorted.end(), upper_ - 1);
+        if(j != i){
+            std::cout << "        < " << std::setw(10) << upper_ << " ns "
+                      << std::setw(10) << (j - i) << std::endl;
+        }
+        i = j;
+        upper_ *= 2;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    std::size_t orders_ = 1'000'000;
+    std::string flow_ = "all";
+    std::string book_ = "all";
+    unsigned int seed_ = 0;
+    bool histogram_ = false;
+
+    for(int i = 1; i < argc; ++i){
+        std::string argument_ = argv[i];
+        if("--histogram" == argument_){
+            histogram_ = true;
+        }else if(i + 1 < argc && "--orders" == argument_){
+            orders_ = std::strtoull(argv[++i], nullptr, 10);
+        }else if(i + 1 < argc && "--flow" == argument_){
+            flow_ = argv[++i];
+        }else if(i + 1 < argc && "--book" == argument_){
+            book_ = argv[++i];
+        }else if(i + 1 < argc && "--seed" == argument_){
+            seed_ = static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10));
+        }else{
+            std::cerr << "usage: " << argv[0]
+                      << " [--orders n] [--flow passive|sweep|cancel_replace|deep|thin]"
+                      << " [--book static|static_tick|paged|binary_tree] [--seed n] [--histogram]"
+                      << std::endl;
+            return 1;
+        }
+    }
+
+    std::minstd_rand generator_(seed_);
+    std::vector<flow> flows_;
+    flows_.push_back(passive_flow(orders_, generator_));
+    flows_.push_back(sweep_flow(orders_, generator_));
+    flows_.push_back(cancel_replace_flow(orders_, generator_));
+    flows_.push_back(mixed_flow("deep", orders_, generator_, 2.));
+    flows_.push_back(mixed_flow("thin", orders_, generator_, 500.));
+
+    std::cout << std::left << std::setw(16) << "flow" << std::setw(14) << "book"
+              << std::right << std::setw(14) << "orders/s"
+              << std::setw(10) << "p50 ns" << std::setw(10) << "p99 ns" << std::setw(12) << "p99.9 ns"
+              << std::setw(12) << "matches" << std::endl;
+
+    bool found_ = false;
+    for(const auto &f: flows_){
+        if("all" != flow_ && f.name != flow_){
+            continue;
+        }
+        for(const auto &type: book_types()){
+            if("all" != book_ && type.name != book_){
+                continue;
+            }
+            found_ = true;
+
+            double seconds_ = 0.;
+            std::vector<std::uint64_t> latencies_;
+            auto reports_ = run<false>(type, f, seconds_, latencies_);
+            double throughput_ = double(f.operations.size() - f.prefill) / seconds_;
+
+            double timed_seconds_ = 0.;
+            run<true>(type, f, timed_seconds_, latencies_);
+            std::sort(latencies_.begin(), latencies_.end());
+
+            std::cout << std::left << std::setw(16) << f.name << std::setw(14) << type.name
+                      << std::right << std::setw(14) << std::fixed << std::setprecision(0) << throughput_
+                      << std::setw(10) << percentile(latencies_, 0.5)
+                      << std::setw(10) << percentile(latencies_, 0.99)
+                      << std::setw(12) << percentile(latencies_, 0.999)
+                      << std::setw(12) << reports_.reports[execution_report::match]
+                      << std::endl;
+            if(histogram_){
+                print_histogram(latencies_);
+            }
+        }
+    }
+
+    if(!found_){
+        std::cerr << "no such flow or book type" << std::endl;
+        return 1;
+    }
+    return 0;
+}
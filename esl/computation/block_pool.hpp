@@ -27,11 +27,19 @@
 #ifndef ESL_BLOCK_POOL_HPP
 #define ESL_BLOCK_POOL_HPP
 
+#include <algorithm>
 #include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <new>
 #include <utility>
 #include <stdexcept>
 #include <vector>
 
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
 
 namespace esl::computation::block_pool {
     ///
@@ -57,10 +65,15 @@ namespace esl::computation::block_pool {
         ///
         typedef std::uint64_t index_t;
 
+        ///
+        /// \brief  Index value of blocks that do not hold an element
+        ///
+        constexpr static index_t unused = (std::numeric_limits<index_t>::max)();
+
         ///
         /// \brief  The index associated with this block
         ///
-        index_t index = 0;
+        index_t index = unused;
 
         ///
         /// \brief  A pointer to the next free block
@@ -73,6 +86,13 @@ namespace esl::computation::block_pool {
     ///          insertion/deletion/indexing
     ///          while maintaining unique strictly increasing indices
     ///
+    /// \details    Storage for `capacity` blocks is allocated up front, but
+    ///             blocks are only constructed a slab at a time, when all
+    ///             constructed blocks are in use. Until then, the operating
+    ///             system does not need to back the remaining storage with
+    ///             memory, so that a pool with a large capacity can start
+    ///             small. Blocks do not move, so pointers stay valid, and
+    ///             indices are computed from the capacity as before.
     ///
     /// \tparam capacity
     /// \tparam element_t_
@@ -92,12 +112,39 @@ namespace esl::computation::block_pool {
         typedef const value_type *const_pointer;
         typedef index_t_ index;
 
+        ///
+        /// \brief  Huge pages are requested for pools of at least this many
+        ///         bytes
+        ///
+        constexpr static size_type huge_page_size = 2 * 1024 * 1024;
+
     private:
 
         ///
-        /// \brief  Underlying container. Needs to be array like (not necessarily dynamically allocated and resizable)
+        /// \brief  Underlying storage for `capacity_` blocks, of which the
+        ///         first `constructed_` are constructed
         ///
-        std::vector<block<element_t_>> blocks;
+        block<element_t_> *blocks;
+
+        size_type capacity_;
+
+        size_type constructed_;
+
+        ///
+        /// \brief  Number of blocks constructed at a time
+        ///
+        size_type slab_;
+
+        ///
+        /// \brief  Whether `blocks` is aligned to huge pages, which
+        ///         determines how it is freed
+        ///
+        bool huge_pages_;
+
+        ///
+        /// \brief  The largest number of elements held at one time
+        ///
+        size_type high_water_;
 
         ///
         /// \brief  Points to first free element
@@ -133,23 +180,86 @@ namespace esl::computation::block_pool {
         ///
         size_type size_;
 
+        ///
+        /// \brief  Constructs the next slab, and makes it the list of free
+        ///         blocks. Only called when all constructed blocks are used.
+        ///
+        void grow_()
+        {
+            const auto first_ = constructed_;
+            const auto last_  = std::min(capacity_, first_ + slab_);
+            for(auto i = first_; i < last_; ++i){
+                new(&blocks[i]) block<element_t_>();
+            }
+            for(auto i = first_ + 1; i < last_; ++i){
+                blocks[i - 1].next = &blocks[i];
+            }
+            constructed_ = last_;
+            end_ = &blocks[first_];
+        }
+
     public:
-        static_block_pool(size_t capacity)
-        : blocks(capacity, block<element_t_>())
+        ///
+        /// \param capacity    maximum number of elements
+        /// \param slab        number of blocks constructed at a time, 0
+        ///                     constructs all blocks immediately
+        /// \param huge_pages  back large pools with huge pages where the
+        ///                     operating system supports it
+        ///
+        explicit static_block_pool( size_t capacity
+                                  , size_t slab = 0
+                                  , bool huge_pages = false)
+        : blocks(nullptr)
+        , capacity_(capacity)
+        , constructed_(0)
+        , slab_(0 == slab ? capacity : std::min(slab, capacity))
+        , huge_pages_(false)
+        , high_water_(0)
         , round_(0)
         , back_(0)
-        , size_(0)
         , highest_(0)
+        , size_(0)
         {
-            blocks[capacity - 1].next = nullptr;
-            for(size_t i = 1; i < capacity; ++i){
-                blocks[capacity - 1 - i].next = &blocks[capacity - i];
+            if(0 == capacity){
+                throw std::length_error("block_pool capacity must be positive");
             }
-            begin_  = &blocks[0];
-            end_    = &blocks[0];
+            const size_type bytes_ = capacity * sizeof(block<element_t_>);
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+            if(huge_pages && huge_page_size <= bytes_){
+                const auto rounded_ = (bytes_ + huge_page_size - 1) / huge_page_size * huge_page_size;
+                void *storage_ = std::aligned_alloc(std::max(huge_page_size, alignof(block<element_t_>)), rounded_);
+                if(storage_){
+                    // advisory, so failure is not an error
+                    madvise(storage_, rounded_, MADV_HUGEPAGE);
+                    blocks = static_cast<block<element_t_> *>(storage_);
+                    huge_pages_ = true;
+                }
+            }
+#else
+            (void)huge_pages;
+#endif
+            if(!blocks){
+                blocks = std::allocator<block<element_t_>>().allocate(capacity);
+            }
+            grow_();
+            begin_ = &blocks[0];
         }
 
-        ~static_block_pool() = default;
+        static_block_pool(const static_block_pool &) = delete;
+
+        static_block_pool &operator = (const static_block_pool &) = delete;
+
+        ~static_block_pool()
+        {
+            for(size_type i = 0; i < constructed_; ++i){
+                blocks[i].~block<element_t_>();
+            }
+            if(huge_pages_){
+                std::free(blocks);
+            }else{
+                std::allocator<block<element_t_>>().deallocate(blocks, capacity_);
+            }
+        }
 
 
         ///
@@ -167,7 +277,45 @@ namespace esl::computation::block_pool {
         /// \return
         [[nodiscard]] size_type capacity() const
         {
-            return blocks.size();
+            return capacity_;
+        }
+
+        ///
+        /// \brief  Number of blocks constructed so far, which bounds the
+        ///         memory in use
+        ///
+        [[nodiscard]] size_type constructed() const
+        {
+            return constructed_;
+        }
+
+        ///
+        /// \brief  The largest number of elements held at one time
+        ///
+        [[nodiscard]] size_type high_water() const
+        {
+            return high_water_;
+        }
+
+        ///
+        /// \brief  Fraction of the constructed blocks that hold an element
+        ///
+        [[nodiscard]] double occupancy() const
+        {
+            return double(size_) / double(constructed_);
+        }
+
+        ///
+        /// \brief  Bytes of the constructed blocks
+        ///
+        [[nodiscard]] size_type memory() const
+        {
+            return constructed_ * sizeof(block<element_t_>);
+        }
+
+        [[nodiscard]] bool huge_pages() const
+        {
+            return huge_pages_;
         }
 
         ///
@@ -211,6 +359,9 @@ namespace esl::computation::block_pool {
             if(size_ >= capacity()) {
                 throw std::length_error("block_pool container at capacity");
             }
+            if(!end_) {
+                grow_();
+            }
 #if DEBUG
             if(end->set) {
                 throw std::logic_error("trying to insert on existing element");
@@ -220,7 +371,7 @@ namespace esl::computation::block_pool {
             auto i        = end_;
             i->data       = e;
             // the offset is the number of positions since the start of the pool
-            size_t offset_ = i - blocks.data();
+            size_t offset_ = i - blocks;
 
             if(back_ > offset_) {
                 ++round_;
@@ -236,6 +387,7 @@ namespace esl::computation::block_pool {
 
             end_ = end_->next;
             ++size_;
+            high_water_ = std::max(high_water_, size_);
 
             // if the offset has decreased, for because of erase()'d elements
             index assigned_ = round_ * capacity() + offset_;
@@ -246,6 +398,7 @@ namespace esl::computation::block_pool {
             }
             highest_ = std::max(highest_, assigned_ + 1);
 
+            i->index = assigned_;
             return {assigned_, i};
         }
 
@@ -259,12 +412,18 @@ namespace esl::computation::block_pool {
             noexcept
 #endif
         {
+            if(constructed_ <= i % capacity()) {
+                return 0;
+            }
             block<element_t_> *removed_ = &blocks[i % capacity()];
             
             if(removed_->index != i) {
                 return 0;
                 //throw esl::exception("trying to delete stale order");
             }
+            // mark the block as unused, so that the stale index can not be
+            // erased or found a second time
+            removed_->index = block<element_t_>::unused;
 
 #if DEBUG
             if(!removed->set) {
@@ -295,6 +454,52 @@ namespace esl::computation::block_pool {
             return 1;
         }
 
+        ///
+        /// \brief  Finds the block holding the element with index i
+        ///
+        /// \return nullptr if the index is not in use, for example because
+        ///         the element was erased.
+        block<element_t_> *find(index i)
+        {
+            if(constructed_ <= i % capacity()) {
+                return nullptr;
+            }
+            block<element_t_> *result_ = &blocks[i % capacity()];
+            return (result_->index == i) ? result_ : nullptr;
+        }
+
+        const block<element_t_> *find(index i) const
+        {
+            if(constructed_ <= i % capacity()) {
+                return nullptr;
+            }
+            const block<element_t_> *result_ = &blocks[i % capacity()];
+            return (result_->index == i) ? result_ : nullptr;
+        }
+
+        ///
+        /// \brief  Position of a block in the underlying container, which is
+        ///         stable for as long as the element is in the pool and fits
+        ///         in fewer bits than the index.
+        ///
+        [[nodiscard]] size_type position(const block<element_t_> *b) const
+        {
+            return static_cast<size_type>(b - blocks);
+        }
+
+        ///
+        /// \brief  The block at a position returned by `position`
+        ///
+        block<element_t_> *block_at(size_type position)
+        {
+            return &blocks[position];
+        }
+
+        const block<element_t_> *block_at(size_type position) const
+        {
+            return &blocks[position];
+        }
+
         ///
         /// \brief  Returns a reference to the element at index i modulo the pool size.
         /// 
@@ -315,7 +520,7 @@ namespace esl::computation::block_pool {
         constexpr reference at(index i)
         {
             assert(blocks[i % capacity()].index == i);
-            block<element_t_> *element_ = blocks[i % capacity()];
+            block<element_t_> *element_ = &blocks[i % capacity()];
 #if DEBUG
             if(!element_->set) {
                 throw std::exception("trying to access non-existing element");
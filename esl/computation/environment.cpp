@@ -150,12 +150,7 @@ namespace esl::computation {
                 iterator_->second->inbox.insert({m->received, m});
 
                 // now that the recipient has a new message, make sure that they wake up on time to do something with it
-                auto recipient_iterator_ = simulation.wake_up_times.find(m->recipient);
-                if(simulation.wake_up_times.end() == recipient_iterator_){
-                    simulation.wake_up_times[m->recipient] = m->received;
-                }else{
-                    (*recipient_iterator_).second = std::min((*recipient_iterator_).second, m->received);
-                }
+                simulation.wake_up_times.decrease(m->recipient, m->received);
 
                 ++messages_;
             }
@@ -0,0 +1,260 @@
+/// \file   hierarchical_bitmap.hpp
+///
+/// \brief  A bitmap with 64-ary summary levels, used to find the nearest set
+///         position in a large sparse range with a few bit-scan operations.
+///
+/// \authors    Maarten P. Scholl
+/// \date       2026-10-17
+/// \copyright  Copyright 2017-2026 The Institute for New Economic Thinking,
+///             Oxford Martin School, University of Oxford
+///
+///             Licensed under the Apache License, Version 2.0 (the "License");
+///             you may not use this file except in compliance with the License.
+///             You may obtain a copy of the License at
+///
+///                 http://www.apache.org/licenses/LICENSE-2.0
+///
+///             Unless required by applicable law or agreed to in writing,
+///             software distributed under the License is distributed on an "AS
+///             IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+///             express or implied. See the License for the specific language
+///             governing permissions and limitations under the License.
+///
+///             You may obtain instructions to fulfill the attribution
+///             requirements in CITATION.cff
+///
+#ifndef ESL_HIERARCHICAL_BITMAP_HPP
+#define ESL_HIERARCHICAL_BITMAP_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+
+namespace esl::computation {
+
+    namespace detail {
+        ///
+        /// \brief  Index of the lowest set bit, `word` must be non-zero
+        ///
+        inline unsigned int count_trailing_zeroes(std::uint64_t word)
+        {
+#if defined(_MSC_VER)
+            unsigned long result_;
+            _BitScanForward64(&result_, word);
+            return static_cast<unsigned int>(result_);
+#else
+            return static_cast<unsigned int>(__builtin_ctzll(word));
+#endif
+        }
+
+        ///
+        /// \brief  Index of the highest set bit, `word` must be non-zero
+        ///
+        inline unsigned int highest_bit(std::uint64_t word)
+        {
+#if defined(_MSC_VER)
+            unsigned long result_;
+            _BitScanReverse64(&result_, word);
+            return static_cast<unsigned int>(result_);
+#else
+            return 63u - static_cast<unsigned int>(__builtin_clzll(word));
+#endif
+        }
+    }
+
+    ///
+    /// \brief  Fixed-size set of positions [0, size), stored as a bitmap with
+    ///         summary levels on top. Each bit in a summary level
+    ///         records whether the corresponding 64-bit word in the level
+    ///         below has any bits set.
+    ///
+    /// \details    Finding the next or previous set position costs
+    ///             O(log_64(size)) word operations, regardless of the number of
+    ///             unset positions in between.
+    ///
+    class hierarchical_bitmap
+    {
+    public:
+        typedef std::size_t size_type;
+
+        ///
+        /// \brief  Returned by `next` and `previous` when no position is set
+        ///
+        constexpr static size_type npos = (std::numeric_limits<size_type>::max)();
+
+    private:
+        constexpr static size_type bits_ = 64;
+
+        ///
+        /// \brief  levels_[0] holds one bit per position, every next level
+        ///         holds one bit per word of the level below. The last level
+        ///         consists of a single word.
+        ///
+        std::vector<std::vector<std::uint64_t>> levels_;
+
+        size_type size_;
+
+    public:
+        explicit hierarchical_bitmap(size_type size = 0)
+        : size_(0)
+        {
+            resize(size);
+        }
+
+        ///
+        /// \brief  Changes the number of positions, clearing all bits.
+        ///
+        void resize(size_type size)
+        {
+            size_ = size;
+            levels_.clear();
+            size_type words_ = (size + bits_ - 1) / bits_;
+            do {
+                words_ = std::max<size_type>(1, words_);
+                levels_.emplace_back(words_, 0);
+                words_ = (words_ + bits_ - 1) / bits_;
+            } while(1 < levels_.back().size());
+        }
+
+        ///
+        /// \brief  Clears all bits.
+        ///
+        void clear()
+        {
+            for(auto &level_: levels_) {
+                std::fill(level_.begin(), level_.end(), 0);
+            }
+        }
+
+        [[nodiscard]] size_type size() const
+        {
+            return size_;
+        }
+
+        [[nodiscard]] bool empty() const
+        {
+            return 0 == levels_.back()[0];
+        }
+
+        [[nodiscard]] bool test(size_type position) const
+        {
+            return 0 != (levels_[0][position / bits_] & (std::uint64_t(1) << (position % bits_)));
+        }
+
+        ///
+        /// \brief  Marks `position` as occupied.
+        ///
+        void set(size_type position)
+        {
+            for(auto &level_ : levels_) {
+                auto &word_ = level_[position / bits_];
+                const bool was_empty_ = (0 == word_);
+                word_ |= std::uint64_t(1) << (position % bits_);
+                // the summary levels already record this word as non-empty
+                if(!was_empty_) {
+                    return;
+                }
+                position /= bits_;
+            }
+        }
+
+        ///
+        /// \brief  Marks `position` as unoccupied.
+        ///
+        void reset(size_type position)
+        {
+            for(auto &level_ : levels_) {
+                auto &word_ = level_[position / bits_];
+                word_ &= ~(std::uint64_t(1) << (position % bits_));
+                // other bits in the word remain, so the summary is unchanged
+                if(0 != word_) {
+                    return;
+                }
+                position /= bits_;
+            }
+        }
+
+        ///
+        /// \brief  Finds the lowest set position that is at least `position`
+        ///
+        /// \return the position, or `npos` if there is none
+        [[nodiscard]] size_type next(size_type position) const
+        {
+            if(position >= size_) {
+                return npos;
+            }
+
+            size_type level_ = 0;
+            // ascend until a word has a set bit at or after the position
+            for(; level_ < levels_.size(); ++level_) {
+                const size_type word_ = position / bits_;
+                if(word_ >= levels_[level_].size()) {
+                    return npos;
+                }
+                const auto masked_ = levels_[level_][word_] & (~std::uint64_t(0) << (position % bits_));
+                if(0 != masked_) {
+                    position = word_ * bits_ + detail::count_trailing_zeroes(masked_);
+                    break;
+                }
+                position = word_ + 1;
+            }
+
+            if(levels_.size() == level_) {
+                return npos;
+            }
+
+            // descend, following the lowest set bit
+            while(0 < level_) {
+                --level_;
+                position = position * bits_ + detail::count_trailing_zeroes(levels_[level_][position]);
+            }
+            return position;
+        }
+
+        ///
+        /// \brief  Finds the highest set position that is at most `position`
+        ///
+        /// \return the position, or `npos` if there is none
+        [[nodiscard]] size_type previous(size_type position) const
+        {
+            if(0 == size_) {
+                return npos;
+            }
+            position = std::min(position, size_ - 1);
+
+            size_type level_ = 0;
+            // ascend until a word has a set bit at or before the position
+            for(; level_ < levels_.size(); ++level_) {
+                const size_type word_ = position / bits_;
+                const auto masked_ = levels_[level_][word_] & (~std::uint64_t(0) >> (bits_ - 1 - position % bits_));
+                if(0 != masked_) {
+                    position = word_ * bits_ + detail::highest_bit(masked_);
+                    break;
+                }
+                if(0 == word_) {
+                    return npos;
+                }
+                position = word_ - 1;
+            }
+
+            if(levels_.size() == level_) {
+                return npos;
+            }
+
+            // descend, following the highest set bit
+            while(0 < level_) {
+                --level_;
+                position = position * bits_ + detail::highest_bit(levels_[level_][position]);
+            }
+            return position;
+        }
+    };
+}
+
+#endif  // ESL_HIERARCHICAL_BITMAP_HPP
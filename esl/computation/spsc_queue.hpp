@@ -0,0 +1,180 @@
+/// \file   spsc_queue.hpp
+///
+/// \brief  A bounded, lock-free queue for exactly one producer thread and
+///         one consumer thread.
+///
+/// \authors    Maarten P. Scholl
+/// \date       2026-10-17
+/// \copyright  Copyright 2017-2026 The Institute for New Economic Thinking,
+///             Oxford Martin School, University of Oxford
+///
+///             Licensed under the Apache License, Version 2.0 (the "License");
+///             you may not use this file except in compliance with the License.
+///             You may obtain a copy of the License at
+///
+///                 http://www.apache.org/licenses/LICENSE-2.0
+///
+///             Unless required by applicable law or agreed to in writing,
+///             software distributed under the License is distributed on an "AS
+///             IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+///             express or implied. See the License for the specific language
+///             governing permissions and limitations under the License.
+///
+///             You may obtain instructions to fulfill the attribution
+///             requirements in CITATION.cff
+///
+#ifndef ESL_SPSC_QUEUE_HPP
+#define ESL_SPSC_QUEUE_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include <esl/exception.hpp>
+
+
+namespace esl::computation {
+
+    ///
+    /// \brief  Ring buffer where the producer only writes the tail and the
+    ///         consumer only writes the head, so that neither needs a lock.
+    ///
+    /// \details    Each side keeps a cached copy of the other side's
+    ///             position, and only reloads it when the queue appears full
+    ///             or empty, which keeps the shared cache lines quiet.
+    ///
+    template<typename element_t_>
+    class spsc_queue
+    {
+    private:
+        constexpr static std::size_t cache_line_ = 64;
+
+        std::vector<element_t_> buffer_;
+
+        const std::size_t mask_;
+
+        ///
+        /// \brief  Written only by the consumer, and read by the producer
+        ///         when the queue appears full
+        ///
+        struct alignas(cache_line_) consumer_t
+        {
+            ///
+            /// \brief  Next position to pop
+            ///
+            std::atomic<std::size_t> head;
+
+            ///
+            /// \brief  The consumer's copy of `producer_.tail`
+            ///
+            std::size_t cached_tail;
+        } consumer_;
+
+        ///
+        /// \brief  Written only by the producer, and read by the consumer
+        ///         when the queue appears empty
+        ///
+        struct alignas(cache_line_) producer_t
+        {
+            ///
+            /// \brief  Next position to push
+            ///
+            std::atomic<std::size_t> tail;
+
+            ///
+            /// \brief  The producer's copy of `consumer_.head`
+            ///
+            std::size_t cached_head;
+        } producer_;
+
+        ///
+        /// \brief  Keeps whatever follows the queue off the producer's
+        ///         cache line, and the one prefetched with it
+        ///
+        char padding_[cache_line_];
+
+    public:
+        ///
+        /// \param capacity must be a power of two
+        ///
+        explicit spsc_queue(std::size_t capacity)
+        : buffer_(capacity)
+        , mask_(capacity - 1)
+        , consumer_{{0}, 0}
+        , producer_{{0}, 0}
+        , padding_{}
+        {
+            if(0 == capacity || 0 != (capacity & (capacity - 1))){
+                throw esl::exception("queue capacity must be a power of two");
+            }
+        }
+
+        [[nodiscard]] std::size_t capacity() const
+        {
+            return buffer_.size();
+        }
+
+        ///
+        /// \brief  Called by the producer only
+        ///
+        /// \return false if the queue is full, in which case `item` is not
+        ///         moved from
+        ///
+        bool try_push(element_t_ &&item)
+        {
+            const auto tail_position_ = producer_.tail.load(std::memory_order_relaxed);
+            if(tail_position_ - producer_.cached_head == buffer_.size()){
+                producer_.cached_head = consumer_.head.load(std::memory_order_acquire);
+                if(tail_position_ - producer_.cached_head == buffer_.size()){
+                    return false;
+                }
+            }
+            buffer_[tail_position_ & mask_] = std::move(item);
+            producer_.tail.store(tail_position_ + 1, std::memory_order_release);
+            return true;
+        }
+
+        bool try_push(const element_t_ &item)
+        {
+            element_t_ copy_(item);
+            return try_push(std::move(copy_));
+        }
+
+        ///
+        /// \brief  Called by the consumer only
+        ///
+        /// \return false if the queue is empty
+        ///
+        bool try_pop(element_t_ &item)
+        {
+            const auto head_position_ = consumer_.head.load(std::memory_order_relaxed);
+            if(head_position_ == consumer_.cached_tail){
+                consumer_.cached_tail = producer_.tail.load(std::memory_order_acquire);
+                if(head_position_ == consumer_.cached_tail){
+                    return false;
+                }
+            }
+            item = std::move(buffer_[head_position_ & mask_]);
+            consumer_.head.store(head_position_ + 1, std::memory_order_release);
+            return true;
+        }
+
+        ///
+        /// \brief  Number of elements, exact only when called by the
+        ///         producer or consumer while the other side is idle
+        ///
+        [[nodiscard]] std::size_t size() const
+        {
+            return producer_.tail.load(std::memory_order_acquire) - consumer_.head.load(std::memory_order_acquire);
+        }
+
+        [[nodiscard]] bool empty() const
+        {
+            return 0 == size();
+        }
+    };
+
+}  // namespace esl::computation
+
+#endif  // ESL_SPSC_QUEUE_HPP
@@ -28,8 +28,12 @@
 
 
 #include <esl/computation/blocking_queue.hpp>
+#include <atomic>
 #include <functional>
 #include <future>
+#include <thread>
+#include <tuple>
+#include <vector>
 
 
 namespace esl::computation {
@@ -63,9 +67,8 @@ namespace esl::computation {
 
         const unsigned int threads;
 
-        explicit thread_pool(unsigned int threads = std::thread::hardware_concurrency())
-        : queues_(threads)
-        , threads(threads)
+    private:
+        static unsigned int available_(unsigned int threads)
         {
             if (0 >= threads) {
                 threads = std::thread::hardware_concurrency();
@@ -74,7 +77,14 @@ namespace esl::computation {
                     threads = 1;
                 }
             }
+            return threads;
+        }
 
+    public:
+        explicit thread_pool(unsigned int threads = std::thread::hardware_concurrency())
+        : queues_(available_(threads))
+        , threads(available_(threads))
+        {
             auto worker_ = [this](auto i) {
                 while (true) {
                     std::function<void(void)> function_;
@@ -92,7 +102,7 @@ namespace esl::computation {
                 }
             };
 
-            for (unsigned int i = 0; i < threads; ++i) {
+            for (unsigned int i = 0; i < this->threads; ++i) {
                 threads_.emplace_back(worker_, i);
             }
         }
@@ -166,7 +176,7 @@ namespace esl::computation {
             auto result_ = task_->get_future();
             unsigned int i = index_++;
 
-            for(auto n = 0; n < (unsigned int)(threads * load_factor); ++n){
+            for(unsigned int n = 0; n < (unsigned int)(threads * load_factor); ++n){
                 if(queues_[(i + n) % threads].try_push(work)){
                     return result_;
                 }
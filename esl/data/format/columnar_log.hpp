@@ -0,0 +1,224 @@
+/// \file   columnar_log.hpp
+///
+/// \brief  An append-only binary log that stores each column contiguously.
+///
+/// \authors    Maarten P. Scholl
+/// \date       2026-10-17
+/// \copyright  Copyright 2017-2026 The Institute for New Economic Thinking,
+///             Oxford Martin School, University of Oxford
+///
+///             Licensed under the Apache License, Version 2.0 (the "License");
+///             you may not use this file except in compliance with the License.
+///             You may obtain a copy of the License at
+///
+///                 http://www.apache.org/licenses/LICENSE-2.0
+///
+///             Unless required by applicable law or agreed to in writing,
+///             software distributed under the License is distributed on an "AS
+///             IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+///             express or implied. See the License for the specific language
+///             governing permissions and limitations under the License.
+///
+///             You may obtain instructions to fulfill the attribution
+///             requirements in CITATION.cff
+///
+#ifndef ESL_COLUMNAR_LOG_HPP
+#define ESL_COLUMNAR_LOG_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <esl/exception.hpp>
+
+
+namespace esl::data {
+
+    ///
+    /// \brief  Writes rows of fixed-width values, buffering them in columns
+    ///         and appending them to the file as blocks.
+    ///
+    /// \details    The file starts with a header: the 8 bytes "ESLCOLS1",
+    ///             the number of columns as uint32, and for each column its
+    ///             width in bytes and the length of its name as uint32,
+    ///             followed by the name. Each block is the number of rows
+    ///             as uint64, followed by the values of each column in turn.
+    ///             Values are written in the byte order of the host, so
+    ///             that a column can be read into memory without
+    ///             conversion.
+    ///
+    /// \tparam column_types_   trivially copyable types of the columns
+    ///
+    template<typename... column_types_>
+    class columnar_log
+    {
+    public:
+        constexpr static std::size_t columns = sizeof...(column_types_);
+
+        static_assert(0 < columns, "a log needs at least one column");
+        static_assert((std::is_trivially_copyable_v<column_types_> && ...)
+                     , "columns must be trivially copyable");
+
+        constexpr static std::array<char, 8> magic = {'E', 'S', 'L', 'C', 'O', 'L', 'S', '1'};
+
+        ///
+        /// \brief  Number of rows written to the file
+        ///
+        std::uint64_t rows = 0;
+
+        ///
+        /// \brief  Number of blocks written to the file
+        ///
+        std::uint64_t blocks = 0;
+
+    private:
+        std::ofstream stream_;
+
+        std::tuple<std::vector<column_types_>...> buffer_;
+
+        std::size_t block_rows_;
+
+        template<typename value_t_>
+        void write_(const value_t_ &value)
+        {
+            stream_.write(reinterpret_cast<const char *>(&value), sizeof(value_t_));
+        }
+
+        template<std::size_t... indices_>
+        void append_(std::index_sequence<indices_...>, const column_types_ &... values)
+        {
+            (std::get<indices_>(buffer_).push_back(values), ...);
+        }
+
+    public:
+        ///
+        /// \param filename    the file is replaced
+        /// \param names       a name for every column, stored in the header
+        /// \param block_rows  number of rows buffered before they are
+        ///                     written
+        ///
+        columnar_log( const std::string &filename
+                    , const std::array<std::string, columns> &names
+                    , std::size_t block_rows = 64 * 1024)
+        : stream_(filename, std::ios::binary | std::ios::trunc)
+        , block_rows_(std::max<std::size_t>(1, block_rows))
+        {
+            if(!stream_){
+                throw esl::exception("can not open " + filename);
+            }
+            stream_.write(magic.data(), magic.size());
+            write_(std::uint32_t(columns));
+            constexpr std::array<std::uint32_t, columns> widths_ = {sizeof(column_types_)...};
+            for(std::size_t i = 0; i < columns; ++i){
+                write_(widths_[i]);
+                write_(std::uint32_t(names[i].size()));
+                stream_.write(names[i].data(), names[i].size());
+            }
+            std::apply([&](auto &... c){ (c.reserve(block_rows_), ...); }, buffer_);
+        }
+
+        columnar_log(const columnar_log &) = delete;
+
+        columnar_log &operator = (const columnar_log &) = delete;
+
+        ~columnar_log()
+        {
+            flush();
+        }
+
+        void append(const column_types_ &... values)
+        {
+            append_(std::index_sequence_for<column_types_...>(), values...);
+            if(block_rows_ <= std::get<0>(buffer_).size()){
+                flush();
+            }
+        }
+
+        ///
+        /// \brief  Number of rows that are not yet written
+        ///
+        [[nodiscard]] std::size_t buffered() const
+        {
+            return std::get<0>(buffer_).size();
+        }
+
+        ///
+        /// \brief  Writes the buffered rows as a block
+        ///
+        void flush()
+        {
+            const std::uint64_t rows_ = buffered();
+            if(0 == rows_){
+                return;
+            }
+            write_(rows_);
+            std::apply([&](auto &... c){
+                (stream_.write(reinterpret_cast<const char *>(c.data()), c.size() * sizeof(c[0])), ...);
+                (c.clear(), ...);
+            }, buffer_);
+            stream_.flush();
+            rows += rows_;
+            ++blocks;
+        }
+
+        ///
+        /// \brief  Reads a log written with the same column types, calling
+        ///         `callback(rows, const column_types_ *...)` for every
+        ///         block.
+        ///
+        /// \return the number of rows read
+        template<typename callback_t_>
+        static std::uint64_t read(const std::string &filename, callback_t_ callback)
+        {
+            std::ifstream stream_(filename, std::ios::binary);
+            if(!stream_){
+                throw esl::exception("can not open " + filename);
+            }
+            auto read_ = [&](auto &value){
+                stream_.read(reinterpret_cast<char *>(&value), sizeof(value));
+                return bool(stream_);
+            };
+
+            std::array<char, magic.size()> magic_;
+            std::uint32_t columns_ = 0;
+            stream_.read(magic_.data(), magic_.size());
+            if(!stream_ || magic != magic_ || !read_(columns_) || columns != columns_){
+                throw esl::exception(filename + " is not a log with " + std::to_string(columns) + " columns");
+            }
+            constexpr std::array<std::uint32_t, columns> widths_ = {sizeof(column_types_)...};
+            for(std::size_t i = 0; i < columns; ++i){
+                std::uint32_t width_ = 0;
+                std::uint32_t length_ = 0;
+                if(!read_(width_) || !read_(length_) || widths_[i] != width_){
+                    throw esl::exception(filename + " has columns of a different width");
+                }
+                stream_.ignore(length_);
+            }
+
+            std::uint64_t result_ = 0;
+            std::tuple<std::vector<column_types_>...> block_;
+            std::uint64_t rows_ = 0;
+            while(read_(rows_)){
+                bool complete_ = true;
+                std::apply([&](auto &... c){
+                    ((c.resize(rows_), complete_ = complete_ && stream_.read(reinterpret_cast<char *>(c.data()), rows_ * sizeof(c[0]))), ...);
+                }, block_);
+                if(!complete_){
+                    throw esl::exception(filename + " ends in an incomplete block");
+                }
+                std::apply([&](const auto &... c){ callback(std::size_t(rows_), c.data()...); }, block_);
+                result_ += rows_;
+            }
+            return result_;
+        }
+    };
+
+}  // namespace esl::data
+
+#endif  // ESL_COLUMNAR_LOG_HPP
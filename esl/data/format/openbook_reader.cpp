@@ -0,0 +1,259 @@
+/// \file   openbook_reader.cpp
+///
+/// \brief
+///
+/// \authors    Maarten P. Scholl
+/// \date       2026-10-17
+/// \copyright  Copyright 2017-2026 The Institute for New Economic Thinking,
+///             Oxford Martin School, University of Oxford
+///
+///             Licensed under the Apache License, Version 2.0 (the "License");
+///             you may not use this file except in compliance with the License.
+///             You may obtain a copy of the License at
+///
+///                 http://www.apache.org/licenses/LICENSE-2.0
+///
+///             Unless required by applicable law or agreed to in writing,
+///             software distributed under the License is distributed on an "AS
+///             IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+///             express or implied. See the License for the specific language
+///             governing permissions and limitations under the License.
+///
+///             You may obtain instructions to fulfill the attribution
+///             requirements in CITATION.cff
+///
+#include "openbook_reader.hpp"
+
+#include <condition_variable>
+#include <exception>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+#include <boost/iostreams/device/file.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+#include <boost/iostreams/filter/gzip.hpp>
+#include <boost/iostreams/filtering_stream.hpp>
+
+#include <esl/data/log.hpp>
+#include <esl/exception.hpp>
+
+
+namespace esl::data {
+
+    namespace {
+        ///
+        /// \brief  Parses whole messages in [begin, begin + messages * size),
+        ///         flushing the batch to the callback whenever it is full.
+        ///
+        std::uint64_t parse_( openbook_parser &parser
+                            , const char *begin
+                            , std::size_t messages
+                            , std::vector<openbook_event> &batch
+                            , std::size_t batch_size
+                            , const openbook_reader::batch_callback &callback
+                            )
+        {
+            std::uint64_t delivered_ = 0;
+            for(std::size_t i = 0; i < messages; ++i){
+                batch.emplace_back();
+                if(!parser.parse(begin + i * openbook_record_size, batch.back())){
+                    batch.pop_back();
+                    continue;
+                }
+                if(batch_size <= batch.size()){
+                    callback(batch.data(), batch.data() + batch.size());
+                    delivered_ += batch.size();
+                    batch.clear();
+                }
+            }
+            return delivered_;
+        }
+
+        void warn_partial_(const std::string &filename, std::uint64_t bytes)
+        {
+            if(0 != bytes % openbook_record_size){
+                LOG(warning) << filename << " does not contain a multiple of "
+                             << openbook_record_size << " bytes, ignoring the last "
+                             << (bytes % openbook_record_size) << " bytes" << std::endl;
+            }
+        }
+    }
+
+    openbook_reader::openbook_reader(std::string filename)
+    : filename(std::move(filename))
+    {
+
+    }
+
+    std::uint64_t openbook_reader::read(const batch_callback &callback, std::size_t batch_size)
+    {
+        if(0 == batch_size){
+            throw esl::exception("batch size must be positive");
+        }
+
+        std::array<unsigned char, 2> magic_ = {};
+        {
+            std::ifstream input_(filename, std::ios::binary);
+            if(!input_){
+                throw esl::exception("can not open " + filename);
+            }
+            input_.read(reinterpret_cast<char *>(magic_.data()), magic_.size());
+            if(input_.gcount() < std::streamsize(magic_.size())){
+                return 0;
+            }
+        }
+
+        if(0x1f == magic_[0] && 0x8b == magic_[1]){
+            return read_compressed_(callback, batch_size);
+        }
+        return read_mapped_(callback, batch_size);
+    }
+
+    std::uint64_t openbook_reader::read_mapped_(const batch_callback &callback, std::size_t batch_size)
+    {
+        boost::iostreams::mapped_file_source file_(filename);
+        warn_partial_(filename, file_.size());
+
+        const std::size_t messages_ = file_.size() / openbook_record_size;
+        records += messages_;
+
+        std::vector<openbook_event> batch_;
+        batch_.reserve(batch_size);
+        auto delivered_ = parse_(parser, file_.data(), messages_, batch_, batch_size, callback);
+        if(!batch_.empty()){
+            callback(batch_.data(), batch_.data() + batch_.size());
+            delivered_ += batch_.size();
+        }
+        return delivered_;
+    }
+
+    std::uint64_t openbook_reader::read_compressed_(const batch_callback &callback, std::size_t batch_size)
+    {
+        // chunks hold whole messages, so that only the last chunk of the
+        // file can end in a partial message
+        constexpr std::size_t chunk_size_ = openbook_record_size * 16 * 1024;
+        constexpr std::size_t chunks_ = 3;
+
+        struct chunk
+        {
+            std::unique_ptr<char[]> data;
+            std::size_t size = 0;
+        };
+
+        std::mutex mutex_;
+        std::condition_variable changed_;
+        std::queue<chunk> free_;
+        std::queue<chunk> full_;
+        bool finished_ = false;
+        bool stopped_ = false;
+        std::exception_ptr error_;
+
+        for(std::size_t i = 0; i < chunks_; ++i){
+            free_.push({std::make_unique<char[]>(chunk_size_), 0});
+        }
+
+        std::thread decompressor_([&](){
+            try{
+                boost::iostreams::filtering_istream input_;
+                input_.push(boost::iostreams::gzip_decompressor());
+                input_.push(boost::iostreams::file_source(filename, std::ios::binary));
+
+                while(true){
+                    chunk chunk_;
+                    {
+                        std::unique_lock<std::mutex> lock_(mutex_);
+                        changed_.wait(lock_, [&](){ return stopped_ || !free_.empty(); });
+                        if(stopped_){
+                            break;
+                        }
+                        chunk_ = std::move(free_.front());
+                        free_.pop();
+                    }
+                    input_.read(chunk_.data.get(), chunk_size_);
+                    chunk_.size = static_cast<std::size_t>(input_.gcount());
+                    const bool end_ = chunk_.size < chunk_size_;
+                    {
+                        std::lock_guard<std::mutex> lock_(mutex_);
+                        full_.push(std::move(chunk_));
+                    }
+                    changed_.notify_all();
+                    if(end_){
+                        break;
+                    }
+                }
+            }catch(...){
+                std::lock_guard<std::mutex> lock_(mutex_);
+                error_ = std::current_exception();
+            }
+            {
+                std::lock_guard<std::mutex> lock_(mutex_);
+                finished_ = true;
+            }
+            changed_.notify_all();
+        });
+
+        // stops and joins the decompressor when the callback throws
+        struct join_guard
+        {
+            std::thread &thread;
+            std::mutex &mutex;
+            std::condition_variable &changed;
+            bool &stopped;
+
+            ~join_guard()
+            {
+                {
+                    std::lock_guard<std::mutex> lock_(mutex);
+                    stopped = true;
+                }
+                changed.notify_all();
+                thread.join();
+            }
+        } guard_ {decompressor_, mutex_, changed_, stopped_};
+
+        std::vector<openbook_event> batch_;
+        batch_.reserve(batch_size);
+        std::uint64_t delivered_ = 0;
+        std::uint64_t bytes_ = 0;
+
+        while(true){
+            chunk chunk_;
+            {
+                std::unique_lock<std::mutex> lock_(mutex_);
+                changed_.wait(lock_, [&](){ return finished_ || !full_.empty(); });
+                if(full_.empty()){
+                    break;
+                }
+                chunk_ = std::move(full_.front());
+                full_.pop();
+            }
+
+            bytes_ += chunk_.size;
+            const std::size_t messages_ = chunk_.size / openbook_record_size;
+            records += messages_;
+            delivered_ += parse_(parser, chunk_.data.get(), messages_, batch_, batch_size, callback);
+
+            {
+                std::lock_guard<std::mutex> lock_(mutex_);
+                free_.push(std::move(chunk_));
+            }
+            changed_.notify_all();
+        }
+
+        if(error_){
+            std::rethrow_exception(error_);
+        }
+        warn_partial_(filename, bytes_);
+
+        if(!batch_.empty()){
+            callback(batch_.data(), batch_.data() + batch_.size());
+            delivered_ += batch_.size();
+        }
+        return delivered_;
+    }
+
+}  // namespace esl::data
@@ -0,0 +1,262 @@
+/// \file   openbook_reader.hpp
+///
+/// \brief  Fast reader for NYSE TAQ OpenBook Ultra files (version 1.2b,
+///         71-byte messages). Uncompressed files are memory-mapped and
+///         parsed in place, gzip-compressed files are decompressed in a
+///         background thread while the previous chunk is parsed.
+///
+/// \authors    Maarten P. Scholl
+/// \date       2026-10-17
+/// \copyright  Copyright 2017-2026 The Institute for New Economic Thinking,
+///             Oxford Martin School, University of Oxford
+///
+///             Licensed under the Apache License, Version 2.0 (the "License");
+///             you may not use this file except in compliance with the License.
+///             You may obtain a copy of the License at
+///
+///                 http://www.apache.org/licenses/LICENSE-2.0
+///
+///             Unless required by applicable law or agreed to in writing,
+///             software distributed under the License is distributed on an "AS
+///             IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+///             express or implied. See the License for the specific language
+///             governing permissions and limitations under the License.
+///
+///             You may obtain instructions to fulfill the attribution
+///             requirements in CITATION.cff
+///
+#ifndef ESL_OPENBOOK_READER_HPP
+#define ESL_OPENBOOK_READER_HPP
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include <esl/economics/markets/order_book/order.hpp>
+
+
+namespace esl::data {
+
+    ///
+    /// \brief  Size of a message in files created 2017-04-20 and after
+    ///
+    constexpr std::size_t openbook_record_size = 71;
+
+    namespace detail {
+        ///
+        /// \brief  Reads a big-endian unsigned integer from a buffer that may
+        ///         be read-only and unaligned.
+        ///
+        template<typename integer_t_>
+        inline integer_t_ load_big_endian(const char *buffer)
+        {
+            integer_t_ result_ = 0;
+            for(std::size_t i = 0; i < sizeof(integer_t_); ++i){
+                result_ = static_cast<integer_t_>(result_ << 8)
+                        | static_cast<unsigned char>(buffer[i]);
+            }
+            return result_;
+        }
+    }  // namespace detail
+
+    ///
+    /// \brief  A price point update, holding only the fields needed to
+    ///         rebuild the book. The symbol is a handle into the
+    ///         `openbook_symbol_table` of the reader.
+    ///
+    struct openbook_event
+    {
+        ///
+        /// \brief  Source time in microseconds since midnight
+        ///
+        std::uint64_t time;
+
+        std::uint32_t symbol;
+
+        ///
+        /// \brief  The price is `price_numerator / 10^price_scale`
+        ///
+        std::uint32_t price_numerator;
+
+        ///
+        /// \brief  Total interest at the price point after this update
+        ///
+        std::uint32_t volume;
+
+        ///
+        /// \brief  Quantity added, cancelled or executed by this update
+        ///
+        std::uint32_t quantity;
+
+        std::uint8_t price_scale;
+
+        ///
+        /// \brief  'O' when the stock is open for the core session, see the
+        ///         OpenBook specification for other values
+        ///
+        char trading_status;
+
+        ///
+        /// \brief  'O' new interest, 'C' cancel, 'E' execution, 'X' multiple
+        ///
+        char reason;
+
+        economics::markets::order_book::limit_order::side_t side;
+    };
+
+    ///
+    /// \brief  Assigns a small integer to every symbol, so that events do
+    ///         not carry strings. Names are stored once, and looked up by
+    ///         views into the raw messages.
+    ///
+    class openbook_symbol_table
+    {
+    public:
+        typedef std::uint32_t handle;
+
+    private:
+        ///
+        /// \brief  A deque does not move its elements, so the views used as
+        ///         keys remain valid
+        ///
+        std::deque<std::string> names_;
+
+        std::unordered_map<std::string_view, handle> handles_;
+
+    public:
+        handle intern(std::string_view name)
+        {
+            auto i = handles_.find(name);
+            if(handles_.end() != i){
+                return i->second;
+            }
+            auto result_ = static_cast<handle>(names_.size());
+            names_.emplace_back(name);
+            handles_.emplace(std::string_view(names_.back()), result_);
+            return result_;
+        }
+
+        [[nodiscard]] const std::string &operator [] (handle h) const
+        {
+            return names_[h];
+        }
+
+        [[nodiscard]] std::size_t size() const
+        {
+            return names_.size();
+        }
+    };
+
+    ///
+    /// \brief  Parses OpenBook messages, interning symbols. Consecutive
+    ///         messages for the same symbol, which is the common case, skip
+    ///         the symbol table.
+    ///
+    class openbook_parser
+    {
+    public:
+        openbook_symbol_table symbols;
+
+    private:
+        std::array<char, 11> last_symbol_ = {};
+
+        openbook_symbol_table::handle last_handle_ = 0;
+
+        bool has_last_ = false;
+
+    public:
+        ///
+        /// \brief  Parses the message at `record`, which must hold
+        ///         `openbook_record_size` bytes.
+        ///
+        /// \return false if the message is not a price point update
+        ///
+        bool parse(const char *record, openbook_event &event)
+        {
+            // +4 message type, 230 full update, 231 delta update. Other
+            // messages are administrative
+            auto type_ = detail::load_big_endian<std::uint16_t>(record + 4);
+            if(230 != type_ && 231 != type_){
+                return false;
+            }
+
+            // +10 symbol, padded on the right
+            const char *symbol_ = record + 10;
+            if(!has_last_ || 0 != std::memcmp(symbol_, last_symbol_.data(), last_symbol_.size())){
+                std::size_t length_ = last_symbol_.size();
+                while(0 < length_ && (' ' == symbol_[length_ - 1] || '\0' == symbol_[length_ - 1])){
+                    --length_;
+                }
+                last_handle_ = symbols.intern(std::string_view(symbol_, length_));
+                std::memcpy(last_symbol_.data(), symbol_, last_symbol_.size());
+                has_last_ = true;
+            }
+            event.symbol = last_handle_;
+
+            // +27 milliseconds since midnight, +31 microseconds
+            event.time = std::uint64_t(detail::load_big_endian<std::uint32_t>(record + 27)) * 1000
+                       + detail::load_big_endian<std::uint16_t>(record + 31);
+            // +34
+            event.trading_status = record[34];
+            // +40
+            event.price_scale = static_cast<std::uint8_t>(record[40]);
+            // +41
+            event.price_numerator = detail::load_big_endian<std::uint32_t>(record + 41);
+            // +45
+            event.volume = detail::load_big_endian<std::uint32_t>(record + 45);
+            // +49
+            event.quantity = detail::load_big_endian<std::uint32_t>(record + 49);
+            // +55
+            event.side = ('B' == record[55])
+                       ? economics::markets::order_book::limit_order::buy
+                       : economics::markets::order_book::limit_order::sell;
+            // +57
+            event.reason = record[57];
+            return true;
+        }
+    };
+
+    ///
+    /// \brief  Reads a whole OpenBook file, delivering price point updates
+    ///         in batches. Files starting with the gzip magic number are
+    ///         decompressed on the fly.
+    ///
+    class openbook_reader
+    {
+    public:
+        typedef std::function<void(const openbook_event *first, const openbook_event *last)> batch_callback;
+
+        std::string filename;
+
+        openbook_parser parser;
+
+        ///
+        /// \brief  Number of messages read, including administrative ones
+        ///
+        std::uint64_t records = 0;
+
+        explicit openbook_reader(std::string filename);
+
+        ///
+        /// \brief  Reads the file, calling `callback` with up to
+        ///         `batch_size` events at a time. A trailing partial message
+        ///         is ignored with a warning.
+        ///
+        /// \return the number of events delivered
+        ///
+        std::uint64_t read(const batch_callback &callback, std::size_t batch_size = 4096);
+
+    private:
+        std::uint64_t read_mapped_(const batch_callback &callback, std::size_t batch_size);
+
+        std::uint64_t read_compressed_(const batch_callback &callback, std::size_t batch_size);
+    };
+
+}  // namespace esl::data
+
+#endif  // ESL_OPENBOOK_READER_HPP
@@ -25,9 +25,18 @@
 #ifndef ME_EXCHANGE_HPP
 #define ME_EXCHANGE_HPP
 
-
+#include <algorithm>
+#include <future>
+#include <limits>
+#include <optional>
+#include <unordered_map>
+
+#include <esl/computation/thread_pool.hpp>
+#include <esl/data/format/columnar_log.hpp>
 #include <esl/economics/markets/market.hpp>
+#include <esl/economics/markets/participant_registry.hpp>
 #include <esl/economics/markets/order_book/basic_book.hpp>
+#include <esl/economics/markets/order_book/call_auction.hpp>
 #include <esl/economics/markets/order_book/order.hpp>
 using namespace esl::economics::markets::order_book;
 
@@ -47,6 +56,7 @@ using esl::interaction::communication::latency_model;
 #include <esl/economics/markets/cancel_order_message.hpp>
 #include <esl/economics/markets/replace_order_message.hpp>
 #include <esl/economics/markets/execution_report_message.hpp>
+#include <esl/economics/markets/execution_report_batch_message.hpp>
 #include <esl/economics/markets/position_request_message.hpp>
 #include <esl/economics/markets/market_data_message.hpp>
 
@@ -81,6 +91,20 @@ namespace esl::economics::markets {
             } type;
 
             std::vector<ticker> traded;
+
+            ///
+            /// \brief  For batch auctions, the time between clearings from
+            ///         the start of the session. 0 clears once, when the
+            ///         session closes. Orders that are not executed remain
+            ///         until the session closes, and are then cancelled.
+            ///
+            simulation::time_duration interval = 0;
+
+            ///
+            /// \brief  For batch auctions, how the executable quantity is
+            ///         divided among orders at the marginal limit
+            ///
+            order_book::call_auction::allocation_t allocation = order_book::call_auction::time_priority;
         };
 
         /// 
@@ -88,6 +112,34 @@ namespace esl::economics::markets {
         /// 
         std::vector<session> sessions;
 
+        ///
+        /// \brief  Orders collected for a batch auction
+        ///
+        struct auction_state
+        {
+            order_book::call_auction book;
+
+            ///
+            /// \brief  Position in `sessions` of the session the orders were
+            ///         submitted in
+            ///
+            std::size_t session = 0;
+
+            ///
+            /// \brief  The time of the next clearing, or the maximum
+            ///         time_point if no orders are waiting
+            ///
+            simulation::time_point clearing = std::numeric_limits<simulation::time_point>::max();
+        };
+
+        boost::container::flat_map<ticker, auction_state> auctions;
+
+        ///
+        /// \brief  Identifier of the first order in an auction, which keeps
+        ///         them distinct from the identifiers given by the books
+        ///
+        constexpr static basic_book::order_identifier auction_identifiers = basic_book::order_identifier(1) << 63;
+
         /// 
         /// \brief  
         /// 
@@ -167,16 +219,38 @@ namespace esl::economics::markets {
         };
 
         ///
-        /// \brief  Maintains trading positions of all market participants.
+        /// \brief  Participants that logged on or subscribed to market data
         ///
-        boost::container::flat_map<ticker, boost::container::flat_map<identity<agent>, position_report>> positions;
+        participant_registry registry;
+
+        ///
+        /// \brief  Maintains trading positions of all market participants,
+        ///         per symbol, indexed by the participant's slot in
+        ///         `registry`.
+        ///
+        boost::container::flat_map<ticker, std::vector<position_report>> positions;
+
+        ///
+        /// \brief  The position of a participant in `symbol`, which is
+        ///         given a slot if it has none
+        ///
+        position_report &position(const ticker &symbol, const identity<agent> &participant)
+        {
+            const auto slot_ = registry.intern(participant);
+            auto &positions_ = positions[symbol];
+            if(positions_.size() <= slot_){
+                positions_.resize(registry.size());
+            }
+            return positions_[slot_];
+        }
 
         struct data_subscription
         {
-            /// 
-            /// 
-            /// 
-            std::uint8_t depth = 0; 
+            ///
+            /// \brief  Number of price levels sent per side, 0 sends the
+            ///         best bid and ask only
+            ///
+            std::uint8_t depth = 0;
 
             ///
             /// \brief  time point from which point onwards to receive market info
@@ -184,24 +258,88 @@ namespace esl::economics::markets {
             esl::simulation::time_point start = 0;
 
             /// 
-            /// \brief  0 means fastest/all
+            /// \brief  0 means fastest/all, which is one update per time point
             /// 
             esl::simulation::time_duration periodicity = 0;
+
+            ///
+            /// \brief  The book changed after the last update was sent
+            ///
+            bool stale = false;
+
+            ///
+            /// \brief  Sequence number of the first trade in
+            ///         `pending_market_data` not yet sent to the subscriber
+            ///
+            std::uint64_t trades = 0;
+
+            ///
+            /// \brief  A snapshot request is answered once, after which the
+            ///         subscription is removed
+            ///
+            [[nodiscard]] bool once() const
+            {
+                return std::numeric_limits<simulation::time_duration>::max() == periodicity;
+            }
         };
 
-        boost::container::flat_map<ticker, boost::container::flat_map<identity<agent>, data_subscription> > market_data_subscriptions;
+        ///
+        /// \brief  Subscriptions per symbol, by participant slot
+        ///
+        boost::container::flat_map<ticker, boost::container::flat_map<participant_registry::slot_t, data_subscription> > market_data_subscriptions;
 
         ///
         /// \brief  contains the anonymised market data sent to data subscribers/requesters
-        /// TODO: make this faster
         ///
-        struct market_data
+        typedef market_data_snapshot market_data;
+
+        ///
+        /// \brief  Trades that not every subscriber to a symbol has
+        ///         received. Trades are numbered in sequence, so that each
+        ///         subscriber receives the trades since its own last update.
+        ///
+        struct trade_log
         {
-            std::vector<std::pair<quote, size_t>> ask;
-            std::vector<std::pair<quote, size_t>> bid;
+            ///
+            /// \brief  Sequence number of `trades.front()`
+            ///
+            std::uint64_t first = 0;
+
             std::vector<std::pair<quote, size_t>> trades;
+
+            ///
+            /// \brief  Sequence number of the next trade
+            ///
+            [[nodiscard]] std::uint64_t end() const
+            {
+                return first + trades.size();
+            }
         };
 
+        ///
+        /// \brief  Symbols with updates that have not been sent to all
+        ///         subscribers
+        ///
+        boost::container::flat_map<ticker, trade_log> pending_market_data;
+
+        ///
+        /// \brief  How execution reports reach the participants
+        ///
+        enum class report_delivery_t
+        { individual    ///< an execution_report_message per report
+        , batched       ///< an execution_report_batch_message per
+                        ///  participant per time point
+        , summarized    ///< batched, with the fills of an order at one
+                        ///  price merged into one report
+        } report_delivery = report_delivery_t::individual;
+
+        ///
+        /// \brief  Number of threads that match orders for different books
+        ///         in parallel. With more than one, orders and cancellations
+        ///         are queued when received, and matched in act().
+        ///
+        unsigned int book_workers = 1;
+
         std::unique_ptr<esl::data::output< std::tuple< ticker
                                                      , quote
                                                      , identity<agent>
@@ -211,6 +349,46 @@ namespace esl::economics::markets {
                                                      >
                                          >> output_orders;
 
+        ///
+        /// \brief  Columns of the binary order log: time, symbol, price
+        ///         value, lot, quantity, side, state and owner
+        ///
+        typedef data::columnar_log< simulation::time_point
+                                  , std::uint32_t
+                                  , std::int64_t
+                                  , std::uint32_t
+                                  , std::uint32_t
+                                  , std::uint8_t
+                                  , std::uint8_t
+                                  , participant_registry::slot_t
+                                  > order_log_t;
+
+        ///
+        /// \brief  Logs the same reports as `output_orders`, in fixed-width
+        ///         columns. Symbols are logged as their position in
+        ///         `order_log_symbols`, and owners as their slot in
+        ///         `registry`.
+        ///
+        std::unique_ptr<order_log_t> order_log;
+
+        ///
+        /// \brief  The symbols in the order log, in order of appearance
+        ///
+        std::vector<ticker> order_log_symbols;
+
+        ///
+        /// \brief  Creates an order log with named columns
+        ///
+        static std::unique_ptr<order_log_t> create_order_log(const std::string &filename, std::size_t block_rows = 64 * 1024)
+        {
+            return std::make_unique<order_log_t>
+                ( filename
+                , std::array<std::string, order_log_t::columns>
+                    {"time", "symbol", "price", "lot", "quantity", "side", "state", "owner"}
+                , block_rows
+                );
+        }
+
         ///
         /// \brief  
         /// 
@@ -223,15 +401,17 @@ namespace esl::economics::markets {
                                                 , std::seed_seq &s)
         {
             (void) s;
+            const auto slot_ = registry.intern(m->sender);
+            registry.activate(slot_);
             for(const auto &t: traded_properties){
-                boost::container::flat_map<identity<agent>, position_report> individual_positions_;
                 position_report position_;
 
-                if(m->supply.find(t) != m->supply.end()){
-                    position_.supply = m->supply.find(t)->second;
+                auto supply_ = m->supply.find(t);
+                if(m->supply.end() != supply_){
+                    position_.supply = supply_->second;
                 }
-                individual_positions_.emplace(m->sender, position_);
-                positions.emplace(t, individual_positions_);
+
+                position(t, m->sender) = position_;
             }
             return ti.upper;
         }
@@ -247,37 +427,381 @@ namespace esl::economics::markets {
                                                   , std::seed_seq &s)
         {
             (void) s;
+            const auto slot_ = registry.find(m->sender);
+            // the individual did not log on
+            if(!slot_.has_value() || !registry.active(slot_.value())) {
+                return ti.upper;
+            }
+            registry.activate(slot_.value(), false);
+
             for(const auto &t: traded_properties){
                 auto positions_ = positions.find(t);
                 // nothing was traded in this market, so no positions recorded
-                if(positions.end() == positions_) { 
-                    continue;
-                }
-
-                auto individual_ = positions_->second.find(m->sender);
-                // the individual did not trade in this market
-                if(positions_->second.end() == individual_) {  
+                if(positions.end() == positions_ || positions_->second.size() <= slot_.value()) { 
                     continue;
                 }
 
+                auto &individual_ = positions_->second[slot_.value()];
                 // test whether trades can clear 
-                if(individual_->second.supply + individual_->second.bought < individual_->second.sold) {
+                if(individual_.supply + individual_.bought < individual_.sold) {
                     LOG(warning)
                         << "participant " << m->sender
                         << " sold more than they supplied - trades won't clear"
                         << std::endl;
                     
                 }
-                positions_->second.erase(individual_);
-                if(positions_->second.empty()) {
-                    positions.erase(positions_);
+                individual_ = position_report();
+            }
+            return ti.upper;
+        }
+
+        ///
+        /// \brief  The session that is open for `symbol` at time `t`. A
+        ///         session without tickers applies to all.
+        ///
+        [[nodiscard]] std::optional<std::size_t> active_session(const ticker &symbol, simulation::time_point t) const
+        {
+            for(std::size_t i = 0; i < sessions.size(); ++i){
+                const auto &s = sessions[i];
+                if(t < s.open.lower || s.open.upper <= t){
+                    continue;
+                }
+                if(s.traded.empty() || s.traded.end() != std::find(s.traded.begin(), s.traded.end(), symbol)){
+                    return i;
+                }
+            }
+            return {};
+        }
+
+    private:
+        ///
+        /// \brief  Position of each symbol in `order_log_symbols`
+        ///
+        boost::container::flat_map<ticker, std::uint32_t> order_log_symbol_indices_;
+
+        ///
+        /// \brief  Writes the report to `output_orders` and `order_log`, if
+        ///         either is set
+        ///
+        void log_report_(simulation::time_point t, const ticker &symbol, const execution_report &r)
+        {
+            if(output_orders) {
+                output_orders->put( t
+                                  , std::make_tuple
+                                    ( symbol
+                                    , r.limit
+                                    , r.owner
+                                    , r.side
+                                    , r.quantity
+                                    , r.state
+                                    ));
+            }
+            if(order_log) {
+                auto [i, inserted_] = order_log_symbol_indices_.try_emplace(symbol, std::uint32_t(order_log_symbols.size()));
+                if(inserted_) {
+                    order_log_symbols.push_back(symbol);
+                }
+                order_log->append( t
+                                 , i->second
+                                 , std::get<price>(r.limit.type).value
+                                 , r.limit.lot
+                                 , r.quantity
+                                 , std::uint8_t(r.side)
+                                 , std::uint8_t(r.state)
+                                 , registry.intern(r.owner));
+            }
+        }
+
+        ///
+        /// \brief  Batches sent in the current time point, by participant
+        ///
+        std::unordered_map<identity<agent>, std::shared_ptr<execution_report_batch_message>> report_batches_;
+
+        ///
+        /// \brief  The first clearing of session `s` after time `t`
+        ///
+        [[nodiscard]] static simulation::time_point next_clearing_(const session &s, simulation::time_point t)
+        {
+            if(0 == s.interval){
+                return s.open.upper;
+            }
+            auto periods_ = (t - s.open.lower) / s.interval + 1;
+            return std::min<simulation::time_point>(s.open.upper, s.open.lower + periods_ * s.interval);
+        }
+
+        ///
+        /// \brief  Sends the report to its owner, or adds it to the owner's
+        ///         batch for this time point
+        ///
+        void send_report_( execution_report report
+                         , const limit_order &order
+                         , simulation::time_interval ti
+                         , std::seed_seq &seed)
+        {
+            if(report_delivery_t::individual != report_delivery){
+                auto &batch_ = report_batches_[report.owner];
+                if(!batch_){
+                    simulation::time_point arrival_ = ti.lower;
+                    if(communication_model) {
+                        arrival_ += communication_model->sample(identifier, report.owner, seed);
+                    }
+                    // the message stays in the outbox, and is filled until
+                    // the end of the time point
+                    batch_ = this->template create_message<execution_report_batch_message>(report.owner, arrival_);
+                    batch_->sender = (*this);
+                    batch_->sent   = ti.lower;
+                }
+                batch_->append(order.symbol, report, report_delivery_t::summarized == report_delivery);
+                return;
+            }
+
+            simulation::time_point arrival_ = ti.lower;
+            if(communication_model) {
+                arrival_ += communication_model->sample(identifier, report.owner, seed);
+            }
+            auto response_ = this->template create_message<execution_report_message>(report.owner, arrival_);
+            response_->sender = (*this);
+            response_->order  = order;
+            response_->sent   = ti.lower;
+            response_->report = std::move(report);
+        }
+
+        ///
+        /// \brief  Clears the auction at the uniform price, and sends the
+        ///         reports in one pass. At the end of the session the
+        ///         remaining orders are cancelled.
+        ///
+        void clear_auction_( const ticker &symbol
+                           , auction_state &state
+                           , simulation::time_interval ti
+                           , std::seed_seq &seed)
+        {
+            const auto &session_ = sessions[state.session];
+            auto result_ = state.book.clear(session_.allocation);
+
+            for(auto &e: result_.executions){
+                log_report_(ti.lower, symbol, e.report);
+                send_report_(std::move(e.report), e.order, ti, seed);
+            }
+
+            // one trade per auction
+            if(result_.price.has_value()){
+                if(auto trades_ = invalidate_market_data_(symbol)){
+                    trades_->push_back({result_.price.value(), result_.volume});
+                }
+            }
+
+            // the exchange may be woken after the session has closed
+            if(session_.open.upper <= std::max(state.clearing, ti.lower)){
+                for(auto &e: state.book.cancel_all()){
+                    send_report_(std::move(e.report), e.order, ti, seed);
                 }
             }
+
+            if(state.book.empty()){
+                state.clearing = std::numeric_limits<simulation::time_point>::max();
+            }else{
+                state.clearing = next_clearing_(session_, ti.lower);
+            }
+        }
+
+        ///
+        /// \brief  Adds the order to the auction of the session, and
+        ///         acknowledges it with a placement report
+        ///
+        simulation::time_point queue_auction_order_( std::shared_ptr<new_order_single_message> m
+                                                   , std::size_t session
+                                                   , simulation::time_interval ti
+                                                   , std::seed_seq &seed)
+        {
+            const auto &order_ = m->order_details;
+            auto &state_ = auctions.try_emplace(order_.symbol, auction_state{order_book::call_auction(auction_identifiers)}).first->second;
+            if(state_.clearing <= ti.lower){
+                clear_auction_(order_.symbol, state_, ti, seed);
+            }
+            if(state_.book.empty()){
+                state_.session = session;
+                state_.clearing = next_clearing_(sessions[session], ti.lower);
+            }
+
+            auto identifier_ = state_.book.insert(order_);
+            send_report_( execution_report( execution_report::placement
+                                          , order_.side
+                                          , order_.quantity
+                                          , identifier_
+                                          , order_.limit
+                                          , order_.owner)
+                        , order_, ti, seed);
             return ti.upper;
         }
 
+        ///
+        /// \brief  Removes the order from its auction, and sends the
+        ///         cancellation report to the owner
+        ///
+        simulation::time_point cancel_auction_order_( std::shared_ptr<cancel_order_message> m
+                                                    , simulation::time_interval ti
+                                                    , std::seed_seq &seed)
+        {
+            auto state_ = auctions.find(m->symbol);
+            if(auctions.end() == state_){
+                return ti.upper;
+            }
+            if(auto cancelled_ = state_->second.book.cancel(m->order)){
+                send_report_(std::move(cancelled_->report), cancelled_->order, ti, seed);
+            }
+            return ti.upper;
+        }
+
+        ///
+        /// \brief  Sends the books that changed to their subscribers.
+        ///         Subscribers that ask for the same depth, and that last
+        ///         received the same trade, share one snapshot. Subscribers
+        ///         receive at most one update per time point, and one per
+        ///         `periodicity`, with all trades since their previous
+        ///         update.
+        ///
+        /// \return the first time a subscriber can receive a postponed
+        ///         update
+        simulation::time_point publish_market_data_( simulation::time_interval ti
+                                                   , std::seed_seq &seed)
+        {
+            simulation::time_point next_ = std::numeric_limits<simulation::time_point>::max();
+            for(auto p = pending_market_data.begin(); p != pending_market_data.end();){
+                const auto &symbol_ = p->first;
+                auto &log_ = p->second;
+                auto subscriptions_ = market_data_subscriptions.find(symbol_);
+                auto book_ = books.find(symbol_);
+                if(market_data_subscriptions.end() == subscriptions_ || books.end() == book_){
+                    p = pending_market_data.erase(p);
+                    continue;
+                }
+
+                boost::container::flat_map<std::pair<std::uint8_t, std::uint64_t>, std::shared_ptr<const market_data_snapshot>> snapshots_;
+                // the first trade that a postponed subscriber has not received
+                auto oldest_ = log_.end();
+                auto &subscribers_ = subscriptions_->second;
+                for(auto s = subscribers_.begin(); s != subscribers_.end();) {
+                    auto &details_ = s->second;
+                    if(!details_.stale){
+                        ++s;
+                        continue;
+                    }
+                    if(ti.lower < details_.start){
+                        oldest_ = std::min(oldest_, details_.trades);
+                        next_ = std::min(next_, details_.start);
+                        ++s;
+                        continue;
+                    }
+
+                    auto &snapshot_ = snapshots_[{details_.depth, details_.trades}];
+                    if(!snapshot_){
+                        auto data_ = std::make_shared<market_data_snapshot>();
+                        // subscriptions without depth receive the top of the book
+                        const auto levels_ = std::max<std::size_t>(1, details_.depth);
+                        for(const auto &l: book_->second->depth(limit_order::sell, levels_)) {
+                            data_->ask.push_back({l.limit, l.quantity});
+                        }
+                        for(const auto &l: book_->second->depth(limit_order::buy, levels_)) {
+                            data_->bid.push_back({l.limit, l.quantity});
+                        }
+                        data_->trades.assign(log_.trades.begin() + std::ptrdiff_t(details_.trades - log_.first), log_.trades.end());
+                        snapshot_ = std::move(data_);
+                    }
+
+                    simulation::time_point arrival_ = ti.lower;
+                    if(communication_model) {
+                        arrival_ += communication_model->sample(identifier, registry[s->first], seed);
+                    }
+                    auto market_data_ = this->template create_message<market_data_message>(registry[s->first], arrival_);
+                    market_data_->sender   = (*this);
+                    market_data_->sent     = ti.lower;
+                    market_data_->symbol   = symbol_;
+                    market_data_->snapshot = snapshot_;
+
+                    if(details_.once()){
+                        s = subscribers_.erase(s);
+                        continue;
+                    }
+                    // the next update is due after the period, or at the next time point
+                    const auto period_ = std::max<simulation::time_duration>(1, details_.periodicity);
+                    details_.start = (std::numeric_limits<simulation::time_point>::max() - ti.lower < period_)
+                                   ? std::numeric_limits<simulation::time_point>::max()
+                                   : ti.lower + period_;
+                    details_.stale = false;
+                    details_.trades = log_.end();
+                    ++s;
+                }
+
+                if(oldest_ < log_.end()){
+                    // drop the trades that all subscribers have received
+                    log_.trades.erase(log_.trades.begin(), log_.trades.begin() + std::ptrdiff_t(oldest_ - log_.first));
+                    log_.first = oldest_;
+                    ++p;
+                }else if(std::any_of(subscribers_.begin(), subscribers_.end(), [](const auto &e){ return e.second.stale; })){
+                    // postponed subscribers that missed no trades
+                    log_.first = log_.end();
+                    log_.trades.clear();
+                    ++p;
+                }else{
+                    // every subscriber is up to date, and the trades are
+                    // numbered from zero again when the symbol is next updated
+                    for(auto &[subscriber_, details_]: subscribers_){
+                        details_.trades = 0;
+                    }
+                    p = pending_market_data.erase(p);
+                }
+            }
+            return next_;
+        }
+
+        ///
+        /// \brief  Marks the subscriptions to `symbol` as stale
+        ///
+        /// \return the trades to include in the next update, or nullptr
+        ///         if there are no subscribers
+        std::vector<std::pair<quote, size_t>> *invalidate_market_data_(const ticker &symbol)
+        {
+            auto subscriptions_ = market_data_subscriptions.find(symbol);
+            if(market_data_subscriptions.end() == subscriptions_ || subscriptions_->second.empty()){
+                return nullptr;
+            }
+            for(auto &[subscriber_, details_]: subscriptions_->second) {
+                details_.stale = true;
+            }
+            return &pending_market_data[symbol].trades;
+        }
+
+    public:
+        ///
+        /// \brief  Clears the auctions that are due, and sends the market
+        ///         data of this time point
+        ///
+        /// \return the next clearing or market data update, if it is
+        ///         before the end of the step
+        simulation::time_point act(simulation::time_interval step, std::seed_seq &seed) override
+        {
+            simulation::time_point next_ = market::act(step, seed);
+            process_book_operations_(step, seed);
+            for(auto &e: auction_cancellations_){
+                send_report_(std::move(e.report), e.order, step, seed);
+            }
+            auction_cancellations_.clear();
+            for(auto &[symbol_, state_]: auctions){
+                if(state_.clearing <= step.lower){
+                    clear_auction_(symbol_, state_, step, seed);
+                }
+                next_ = std::min(next_, state_.clearing);
+            }
+            next_ = std::min(next_, publish_market_data_(step, seed));
+            report_batches_.clear();
+            return next_;
+        }
+
         ///
         /// \brief  Handles a single order, and sends the reports that it generates.
+        ///         During a batch auction session, the order is collected
+        ///         for the next clearing instead.
         ///
         /// \param m
         /// \param ti
@@ -298,16 +822,107 @@ namespace esl::economics::markets {
                 throw esl::exception("Invalid ticker in limit order.");
             }
 
-            order_book::basic_book &b = *(i->second);
+            if(auto session_ = active_session(m->order_details.symbol, ti.lower);
+               session_.has_value() && session::session_t::batch_auction == sessions[session_.value()].type) {
+                return queue_auction_order_(m, session_.value(), ti, seed);
+            }
+
+            book_operation operation_;
+            operation_.order = std::move(m);
+            operation_.book  = i->second.get();
+            if(1 < book_workers) {
+                book_operations_.push_back(std::move(operation_));
+                return ti.upper;
+            }
+            match_(operation_);
+            dispatch_(operation_, ti, seed);
+            return ti.upper;
+        }
+
+    private:
+        ///
+        /// \brief  An order or cancellation for one of the books, and its
+        ///         effect on the book
+        ///
+        struct book_operation
+        {
+            ///
+            /// \brief  The order to insert, or nullptr for a cancellation
+            ///
+            std::shared_ptr<new_order_single_message> order;
+
+            order_book::basic_book *book = nullptr;
+
+            basic_book::order_identifier cancel = basic_book::direct_order;
+
+            std::optional<quote> ask;
+
+            std::optional<quote> bid;
+
+            bool quote_changed = false;
+
+            std::vector<execution_report> reports;
+        };
 
-            const auto ask_ = b.ask();
-            const auto bid_ = b.bid();
+        ///
+        /// \brief  Operations queued in this time point, in the order they
+        ///         were received, when books are matched in parallel
+        ///
+        std::vector<book_operation> book_operations_;
 
-            b.insert(m->order_details);
+        ///
+        /// \brief  Auction orders cancelled through cancel(), of which the
+        ///         reports are sent in the next act()
+        ///
+        std::vector<order_book::call_auction::execution> auction_cancellations_;
 
-            market_data data_;
+        ///
+        /// \brief  Threads that help match books, besides the exchange's
+        ///         own. Created on first use.
+        ///
+        std::shared_ptr<computation::thread_pool> pool_;
+
+        ///
+        /// \brief  Applies the operation to its book. This only touches the
+        ///         book, so operations on different books can run in
+        ///         parallel.
+        ///
+        static void match_(book_operation &operation)
+        {
+            auto &b = *operation.book;
+            if(!operation.order) {
+                // reports of cancellations stay in the book, and are sent
+                // with the next order
+                b.cancel(operation.cancel);
+                return;
+            }
+
+            operation.ask = b.ask();
+            operation.bid = b.bid();
+            b.insert(operation.order->order_details);
+            operation.reports = std::move(b.reports);
+            b.reports.clear();
+            operation.quote_changed = (operation.ask != b.ask() || operation.bid != b.bid());
+        }
+
+        ///
+        /// \brief  Logs and sends the reports generated by an order
+        ///
+        void dispatch_( book_operation &operation
+                      , simulation::time_interval ti
+                      , std::seed_seq &seed)
+        {
+            if(!operation.order) {
+                return;
+            }
+            const auto &m = operation.order;
+            std::vector<std::pair<quote, size_t>> trades_;
+
+            for(auto &generated_: operation.reports){
+                // the report is sent to the participants involved after it
+                // is logged
+                const execution_report &r = generated_;
 
-            for(const auto & r: b.reports){
                 //////////////////////////////////////////////////////////////////////////////////////////////////////
                 //if(r.owner == m->sender) {
                 //    if(r.state == execution_report::state_t::match) {
@@ -349,78 +964,85 @@ namespace esl::economics::markets {
 
                 // we do not log rejected messages, so that later analyses do not accidently use these
                 // invalid orders should not be part of the simulation
-                if(output_orders && r.state != execution_report::state_t::invalid && r.owner == m->sender) {
-                    output_orders->put( ti.lower
-                                      , std::make_tuple
-                                        ( m->order_details.symbol
-                                        , r.limit
-                                        , r.owner
-                                        , r.side
-                                        , r.quantity
-                                        , r.state
-                                        ));
+                if(r.state != execution_report::state_t::invalid && r.owner == m->sender) {
+                    log_report_(ti.lower, m->order_details.symbol, r);
                 }
 
-                // notify the participants involved in the trade
-                {
-                    simulation::time_point arrival_ = ti.lower;
-                    if(communication_model) {
-                        arrival_ += communication_model->sample(identifier, m->sender, seed);
-                    }
-                    auto response_ = this->template create_message<execution_report_message>(r.owner, arrival_);
-                    response_->sender = (*this);
-                    response_->order  = m->order_details;
-                    response_->sent   = ti.lower;
-                    response_->report = r;
-                }
-                // if no one wants market data on this symbol, skip the next steps.
-                if(market_data_subscriptions.end() == market_data_subscriptions.find(m->order_details.symbol)) {
-                    continue;
-                }
                 // if the order resulted in a match, update market data feed (once, as there will be two reports)
-                auto trade_ = (r.state == execution_report::state_t::match);
-                // or if the bed bid or ask improved
-                auto best_bid_ask_ = (ask_ != b.ask() || bid_ != b.bid());
-                if((trade_ && r.owner == m->sender) || best_bid_ask_){
-                    for(auto &[subscriber_, details_]: market_data_subscriptions[m->order_details.symbol]) {
-
-                        if(details_.start + details_.periodicity > ti.lower) {
-                            continue;
-                        }
+                if(r.state == execution_report::state_t::match && r.owner == m->sender){
+                    trades_.emplace_back(r.limit, r.quantity);
+                }
 
-                        // change the start of the next data subscription fulfillment, so that we dont overload them
-                        // 
-                        details_.start = ti.lower;
+                send_report_(std::move(generated_), m->order_details, ti, seed);
+            }
 
+            // or if the best bid or ask changed. Market data is sent from
+            // act(), once per time point
+            if(!trades_.empty() || operation.quote_changed){
+                if(auto pending_ = invalidate_market_data_(m->order_details.symbol)){
+                    pending_->insert(pending_->end(), trades_.begin(), trades_.end());
+                }
+            }
+        }
 
-                        simulation::time_point arrival_ = ti.lower;
-                        if(communication_model) {
+        ///
+        /// \brief  Matches the queued operations, with the books divided
+        ///         over `book_workers` threads, then sends the reports in
+        ///         the order the operations were received. The messages
+        ///         are therefore the same as when processing serially.
+        ///
+        void process_book_operations_(simulation::time_interval ti, std::seed_seq &seed)
+        {
+            if(book_operations_.empty()) {
+                return;
+            }
 
-                            arrival_ += communication_model->sample(
-                                identifier, subscriber_, seed);
-                        }
-                        auto market_data_ = this->template create_message<market_data_message>(subscriber_, arrival_);
-                        market_data_->sender = (*this);
-                        market_data_->sent   = ti.lower;
-                        market_data_->symbol = m->order_details.symbol;
+            // the operations of each book, in the order received
+            boost::container::flat_map<order_book::basic_book *, std::vector<book_operation *>> streams_;
+            for(auto &o: book_operations_) {
+                streams_[o.book].push_back(&o);
+            }
 
-                        if(trade_) {
-                            market_data_->trades.push_back({r.limit, r.quantity});
-                        }
-                        
-                        if(b.ask().has_value()) {
-                            market_data_->ask.push_back({b.ask().value(), 1});
-                        }
-                        if(b.bid().has_value()) {
-                            market_data_->bid.push_back({b.bid().value(), 1});
-                        }
+            const auto workers_ = std::min<std::size_t>(book_workers, streams_.size());
+            auto work_ = [&](std::size_t worker){
+                for(std::size_t i = worker; i < streams_.size(); i += workers_) {
+                    for(auto *o: (streams_.begin() + i)->second) {
+                        match_(*o);
                     }
                 }
+            };
+            if(1 < workers_ && (!pool_ || pool_->threads + 1 != book_workers)) {
+                pool_ = std::make_shared<computation::thread_pool>(book_workers - 1);
             }
-            b.reports.clear();
-            return ti.upper;
+            std::vector<std::future<void>> helpers_;
+            for(std::size_t w = 1; w < workers_; ++w) {
+                helpers_.push_back(pool_->enqueue_task(work_, w));
+            }
+            try{
+                work_(0);
+            }catch(...){
+                for(auto &h: helpers_){
+                    h.wait();
+                }
+                throw;
+            }
+            // the helpers refer to the operations, so all of them finish
+            // before an exception from one of them is rethrown
+            for(auto &h: helpers_){
+                h.wait();
+            }
+            for(auto &h: helpers_){
+                h.get();
+            }
+
+            for(auto &o: book_operations_) {
+                dispatch_(o, ti, seed);
+            }
+            book_operations_.clear();
         }
 
+    public:
+
         ///
         /// \brief  Create a market for a collection of tradeable properties.
         ///
@@ -434,7 +1056,7 @@ namespace esl::economics::markets {
             books.reserve(traded.size());
 
             for(const auto &t: traded){
-                positions.emplace(t, boost::container::flat_map<identity<agent>, position_report>());
+                positions.emplace(t, std::vector<position_report>());
             }
 
             ////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -470,17 +1092,21 @@ namespace esl::economics::markets {
                             // periodicity is set to max
                       
                             auto subscription_ =
-                                market_data_subscriptions[i].find(m->sender);
+                                market_data_subscriptions[i].find(registry.intern(m->sender));
 
                             centralized_exchange::data_subscription s;
                             s.depth       = m->depth;
                             s.start       = ti.lower;
                             s.periodicity = std::numeric_limits<simulation::time_point>::max();
+                            s.stale       = true;
+
+                            // trades before the request are not included
+                            s.trades      = pending_market_data[i].end();
 
                             if(market_data_subscriptions[i].end()
                                == subscription_) {
-                                market_data_subscriptions[i].insert(
-                                    {m->sender, s});
+                                market_data_subscriptions[i].emplace(
+                                    registry.intern(m->sender), s);
                             } else {
                                 subscription_->second = s;
                             }
@@ -490,24 +1116,26 @@ namespace esl::economics::markets {
                             if(market_data_subscriptions.end() == instrument_) {
                                 continue;
                             }
-                            auto subscription_ = market_data_subscriptions[i].find(m->sender);
-                            market_data_subscriptions[i].erase(subscription_);
+                            if(auto slot_ = registry.find(m->sender); slot_.has_value()) {
+                                instrument_->second.erase(slot_.value());
+                            }
                         }else if(market_data_request_message::stream == m->type) {
-                            auto instrument_ = market_data_subscriptions.find(i);
-                            if(market_data_subscriptions.end() == instrument_) {
+                            if(books.end() == books.find(i)) {
                                 continue;
                             }
-                        
-                            auto subscription_ = market_data_subscriptions[i].find(m->sender);
+
+                            auto subscription_ = market_data_subscriptions[i].find(registry.intern(m->sender));
 
                               centralized_exchange::data_subscription s;
                               s.depth = m->depth;
                               s.start = ti.lower;
                               s.periodicity = 0;
+                              s.stale = true;
+                              s.trades = pending_market_data[i].end();
 
                             if(market_data_subscriptions[i].end() == subscription_){
-                                market_data_subscriptions[i].insert(
-                                    {m->sender, s});
+                                market_data_subscriptions[i].emplace(
+                                    registry.intern(m->sender), s);
                             }else{
                                 subscription_->second = s;
                             }
@@ -543,6 +1171,17 @@ namespace esl::economics::markets {
                                       , simulation::time_interval step
                                       , std::seed_seq &s) 
                                     { 
+                                        if(auction_identifiers <= m->order) {
+                                            return cancel_auction_order_(m, step, s);
+                                        }
+                                        auto i = books.find(m->symbol);
+                                        if(1 < book_workers && books.end() != i) {
+                                            book_operation operation_;
+                                            operation_.book   = i->second.get();
+                                            operation_.cancel = m->order;
+                                            book_operations_.push_back(std::move(operation_));
+                                            return step.upper;
+                                        }
                                         cancel(m->symbol, m->order); 
                                         return step.upper;
                                     }
@@ -572,6 +1211,10 @@ namespace esl::economics::markets {
             return *(i->second);
         }
 
+        ///
+        /// \brief  Cancels the order. The report of a cancelled auction
+        ///         order is sent to its owner from act(), as continuous
+        ///         books send theirs with the next order.
         ///
         /// \param symbol
         /// \param identifier
@@ -579,6 +1222,15 @@ namespace esl::economics::markets {
                     const typename basic_book::order_identifier
                         identifier)
         {
+            if(auction_identifiers <= identifier) {
+                auto a = auctions.find(symbol);
+                if(auctions.end() != a){
+                    if(auto cancelled_ = a->second.book.cancel(identifier)){
+                        auction_cancellations_.push_back(std::move(cancelled_.value()));
+                    }
+                }
+                return;
+            }
             auto i = books.find(symbol);
             if(books.end() != i){
                 i->second->cancel(identifier);
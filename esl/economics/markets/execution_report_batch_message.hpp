@@ -0,0 +1,115 @@
+/// \file   execution_report_batch_message.hpp
+///
+/// \brief  All execution reports for one participant in one time point.
+///
+/// \authors    Maarten P. Scholl
+/// \date       2026-10-17
+/// \copyright  Copyright 2017-2026 The Institute for New Economic Thinking,
+///             Oxford Martin School, University of Oxford
+///
+///             Licensed under the Apache License, Version 2.0 (the "License");
+///             you may not use this file except in compliance with the License.
+///             You may obtain a copy of the License at
+///
+///                 http://www.apache.org/licenses/LICENSE-2.0
+///
+///             Unless required by applicable law or agreed to in writing,
+///             software distributed under the License is distributed on an "AS
+///             IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+///             express or implied. See the License for the specific language
+///             governing permissions and limitations under the License.
+///
+///             You may obtain instructions to fulfill the attribution
+///             requirements in CITATION.cff
+///
+#ifndef ESL_EXECUTION_REPORT_BATCH_MESSAGE_HPP
+#define ESL_EXECUTION_REPORT_BATCH_MESSAGE_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include <esl/interaction/message.hpp>
+#include <esl/economics/markets/order_book/execution_report.hpp>
+#include <esl/economics/markets/order_book/order.hpp>
+
+namespace esl::economics::markets {
+    ///
+    /// \brief  Replaces the individual execution_report_messages sent to a
+    ///         participant, if the exchange is configured to batch reports.
+    ///
+    struct execution_report_batch_message
+    : public interaction::message< execution_report_batch_message
+    , interaction::library_message_code<0x00C0C>()
+    >
+    {
+        struct entry
+        {
+            ///
+            /// \brief  Position of the order's symbol in `symbols`
+            ///
+            std::uint32_t symbol;
+
+            order_book::execution_report report;
+        };
+
+        ///
+        /// \brief  The symbols the reports refer to
+        ///
+        std::vector<ticker> symbols;
+
+        ///
+        /// \brief  Reports in the order they were generated
+        ///
+        std::vector<entry> reports;
+
+        explicit execution_report_batch_message( const identity<agent> &sender     = identity<agent>()
+                                               , const identity<agent> &recipient  = identity<agent>()
+                                               , simulation::time_point sent       = simulation::time_point()
+                                               , simulation::time_point received   = simulation::time_point()
+                                               )
+        : interaction::message< execution_report_batch_message
+                              , interaction::library_message_code<0x00C0C>()
+                              >::message(sender, recipient, sent, received)
+        {
+
+        }
+
+        ///
+        /// \brief  Appends a report
+        ///
+        /// \param summarize   merge a match into the previous report of the
+        ///                     same order, if that is a match at the same
+        ///                     price
+        ///
+        void append(const ticker &symbol, const order_book::execution_report &report, bool summarize = false)
+        {
+            // participants typically trade few symbols, so search from the back
+            auto s = std::find(symbols.rbegin(), symbols.rend(), symbol);
+            std::uint32_t index_;
+            if(symbols.rend() == s){
+                index_ = static_cast<std::uint32_t>(symbols.size());
+                symbols.push_back(symbol);
+            }else{
+                index_ = static_cast<std::uint32_t>(symbols.rend() - s - 1);
+            }
+
+            if(summarize && order_book::execution_report::match == report.state){
+                for(auto e = reports.rbegin(); e != reports.rend(); ++e){
+                    if(e->symbol != index_ || e->report.identifier != report.identifier){
+                        continue;
+                    }
+                    if(order_book::execution_report::match == e->report.state && e->report.limit == report.limit){
+                        e->report.quantity += report.quantity;
+                        return;
+                    }
+                    break;
+                }
+            }
+            reports.push_back({index_, report});
+        }
+    };
+}//namespace esl::economics::markets
+
+
+#endif//ESL_EXECUTION_REPORT_BATCH_MESSAGE_HPP
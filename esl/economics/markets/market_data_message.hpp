@@ -25,10 +25,29 @@
 #ifndef ESL_MARKET_DATA_MESSAGE_HPP
 #define ESL_MARKET_DATA_MESSAGE_HPP
 
+#include <memory>
+
 #include <esl/interaction/message.hpp>
 #include <esl/economics/markets/order_book/order.hpp>
 
 namespace esl::economics::markets {
+    ///
+    /// \brief  The state of one book at one time point. Snapshots are not
+    ///         modified after they are sent, so that the messages to all
+    ///         subscribers can share one.
+    ///
+    struct market_data_snapshot
+    {
+        std::vector<std::pair<quote, size_t>> ask;
+
+        std::vector<std::pair<quote, size_t>> bid;
+
+        ///
+        /// \brief  Trades since the previous snapshot of the book
+        ///
+        std::vector<std::pair<quote, size_t>> trades;
+    };
+
     ///
     /// \brief
     ///
@@ -44,11 +63,7 @@ namespace esl::economics::markets {
 
         // TODO: decide to add timestamp or not 
 
-        std::vector<std::pair<quote, size_t>> ask;
-
-        std::vector<std::pair<quote, size_t>> bid;
-        
-        std::vector<std::pair<quote, size_t>> trades;
+        std::shared_ptr<const market_data_snapshot> snapshot;
 
         explicit market_data_message( const identity<agent> &sender    = identity<agent>()
                                     , const identity<agent> &recipient = identity<agent>()
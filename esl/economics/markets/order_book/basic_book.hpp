@@ -26,11 +26,14 @@
 #define ESL_BASIC_BOOK_HPP
 
 
+#include <algorithm>
 #include <cstdint>
+#include <memory>
 #include <optional>
 #include <vector>
 
 #include <esl/economics/markets/order_book/execution_report.hpp>
+#include <esl/economics/markets/order_book/report_sink.hpp>
 #include <esl/economics/markets/quote.hpp>
 
 
@@ -51,10 +54,17 @@ namespace esl::economics::markets::order_book {
         constexpr static const order_identifier direct_order = (std::numeric_limits<order_identifier>::max)();
 
         ///
-        /// \brief  Sequence of execution reports as they were
+        /// \brief  Sequence of execution reports as they were generated,
+        ///         when no `sink` is set
         ///
         std::vector<execution_report> reports;
 
+        ///
+        /// \brief  When set, receives the execution reports as they are
+        ///         generated instead of `reports`
+        ///
+        std::shared_ptr<report_sink> sink;
+
         ///
         /// \brief  Constructs the base class for order books, which reserves
         ///         memory to store execution reports.
@@ -94,6 +104,82 @@ namespace esl::economics::markets::order_book {
         /// \param order identifier the order book gave once the order was places
         virtual void cancel(order_identifier order) = 0;
 
+        ///
+        /// \brief  Inserts a sequence of orders, in order of arrival. The
+        ///         space for the reports is reserved once for the batch.
+        ///
+        /// \details    Books override this to call their own `insert`
+        ///             without a virtual call per order.
+        ///
+        /// \param first   first order in a contiguous sequence
+        /// \param last    one past the last order
+        virtual void insert(const limit_order *first, const limit_order *last)
+        {
+            reserve_reports(static_cast<std::size_t>(last - first));
+            for(; first != last; ++first){
+                insert(*first);
+            }
+        }
+
+        void insert(const std::vector<limit_order> &orders)
+        {
+            insert(orders.data(), orders.data() + orders.size());
+        }
+
+        ///
+        /// \brief  Cancels a sequence of orders, in order
+        ///
+        virtual void cancel(const order_identifier *first, const order_identifier *last)
+        {
+            reserve_reports(static_cast<std::size_t>(last - first));
+            for(; first != last; ++first){
+                cancel(*first);
+            }
+        }
+
+        void cancel(const std::vector<order_identifier> &orders)
+        {
+            cancel(orders.data(), orders.data() + orders.size());
+        }
+
+    protected:
+        ///
+        /// \brief  Passes a report to the sink, or appends it to `reports`
+        ///
+        void report( execution_report::state_t state
+                   , limit_order::side_t side
+                   , std::uint32_t quantity
+                   , order_identifier identifier
+                   , const quote &limit
+                   , const identity<agent> &owner
+                   )
+        {
+            if(sink){
+                sink->consume(state, side, quantity, identifier, limit, owner);
+            }else{
+                reports.emplace_back(state, side, quantity, identifier, limit, owner);
+            }
+        }
+
+        ///
+        /// \brief  Reserves space for the reports of a batch of orders, at
+        ///         least one report per order.
+        ///
+        void reserve_reports(std::size_t orders)
+        {
+            if(sink){
+                return;
+            }
+            const auto required_ = reports.size() + orders;
+            if(reports.capacity() < required_){
+                // grow geometrically, so that many small batches do not
+                // reallocate every time
+                reports.reserve(std::max(required_, 2 * reports.capacity()));
+            }
+        }
+
+    public:
+
         ///
         /// \brief  Obtains a vector of active orders.
         /// 
@@ -101,13 +187,33 @@ namespace esl::economics::markets::order_book {
 
 
         ///
-        /// \brief  Gets the n-th level in the order book and returns the associated quote and market depth
+        /// \brief  Aggregate of the resting orders at a single limit price
         ///
-        /// \param level
-        /// \param side
-        /// \return
-        //virtual std::optional<std::pair<quote, std::uint64_t>> level(std::uint64_t level, limit_order::side_t side) const = 0;
+        struct depth_level
+        {
+            quote limit;
 
+            ///
+            /// \brief  Total remaining quantity of the orders at this level
+            ///
+            std::uint64_t quantity;
+
+            ///
+            /// \brief  Number of orders at this level
+            ///
+            std::uint32_t orders;
+        };
+
+        ///
+        /// \brief  Gets the market depth on one side of the book. Books keep
+        ///         the aggregates per level up to date on every insert, match
+        ///         and cancel, so the cost is in the number of levels
+        ///         requested and not in the number of orders.
+        ///
+        /// \param side    buy for bids, sell for asks
+        /// \param levels  maximum number of levels to return
+        /// \return the occupied levels, starting with the best price
+        [[nodiscard]] virtual std::vector<depth_level> depth(limit_order::side_t side, std::size_t levels) const = 0;
 
         ///
         /// \brief  Renders the order book to the console at 80 characters width
@@ -28,12 +28,18 @@
 #ifndef ME_BINARY_TREE_ORDER_BOOK_HPP
 #define ME_BINARY_TREE_ORDER_BOOK_HPP
 
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <limits>
 #include <map>
-#include <queue>
 #include <string>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include <esl/economics/markets/order_book/basic_book.hpp>
+#include <esl/economics/markets/order_book/resting_order.hpp>
 
 #include <esl/mathematics/interval.hpp>
 #include <esl/data/log.hpp>
@@ -43,20 +49,188 @@ namespace esl::economics::markets::order_book {
     ///
     /// \brief  Memory-efficient, dynamically allocated order book
     ///
-    /// \todo:
+    /// \details    Orders are grouped by price level in an ordered map per
+    ///             side. Each level holds a first-in-first-out queue of
+    ///             orders, linked through a pool of nodes that grows when
+    ///             needed and reuses the nodes of orders that were removed.
+    ///             Cancellation finds the node through a hash index on the
+    ///             order identifier.
     ///
-    
     class binary_tree_order_book 
     : public basic_book
     {
     public:
+        ///
+        /// \brief  Position of a node in the node pool
+        ///
+        typedef std::uint32_t link;
+
+        constexpr static link no_link = (std::numeric_limits<link>::max)();
+
+        ///
+        /// \brief  The queue of orders at a single limit price
+        ///
+        struct price_level
+        {
+            ///
+            /// \brief  The order with the highest time priority
+            ///
+            link first = no_link;
+
+            ///
+            /// \brief  The most recently placed order
+            ///
+            link last = no_link;
+
+            ///
+            /// \brief  Total remaining quantity of the orders at this level
+            ///
+            std::uint64_t quantity = 0;
+
+            ///
+            /// \brief  Number of orders at this level
+            ///
+            std::uint32_t orders = 0;
+        };
+
+        ///
+        /// \brief  Price levels in ascending order of price, so the best bid
+        ///         is the last and the best ask the first level
+        ///
+        typedef std::map<quote, price_level> levels_t;
+
+        ///
+        /// \brief  An order resting in the book
+        ///
+        struct node
+        {
+            basic_book::order_identifier identifier;
+
+            ///
+            /// \brief  The price level the order is queued at
+            ///
+            levels_t::iterator level;
 
+            std::uint32_t quantity = 0;
+
+            owner_table::handle owner = 0;
+
+            limit_order::side_t side = limit_order::buy;
+
+            link previous = no_link;
+
+            link next = no_link;
+        };
 
     private:
         basic_book::order_identifier  next_;
 
+        ///
+        /// \brief  Nodes for resting orders, and nodes that were released
+        ///
+        std::vector<node> nodes_;
+
+        ///
+        /// \brief  Released nodes, reused before the pool is grown
+        ///
+        std::vector<link> free_;
+
+        ///
+        /// \brief  Finds the node of a resting order for cancellation
+        ///
+        std::unordered_map<basic_book::order_identifier, link> index_;
+
+        ///
+        /// \brief  Identities of the participants with resting orders
+        ///
+        owner_table owners_;
+
+        link allocate_()
+        {
+            if(!free_.empty()){
+                auto result_ = free_.back();
+                free_.pop_back();
+                return result_;
+            }
+            nodes_.emplace_back();
+            return static_cast<link>(nodes_.size() - 1);
+        }
+
+        ///
+        /// \brief  Removes the node from the queue of its level, removing
+        ///         the level when it is empty, and releases the node.
+        ///
+        void remove_(link n)
+        {
+            node &node_ = nodes_[n];
+            price_level &level_ = node_.level->second;
+
+            if(no_link != node_.previous){
+                nodes_[node_.previous].next = node_.next;
+            }else{
+                level_.first = node_.next;
+            }
+
+            if(no_link != node_.next){
+                nodes_[node_.next].previous = node_.previous;
+            }else{
+                level_.last = node_.previous;
+            }
+
+            level_.quantity -= node_.quantity;
+            --level_.orders;
+            if(0 == level_.orders){
+                (limit_order::buy == node_.side ? bids : asks).erase(node_.level);
+            }
+
+            index_.erase(node_.identifier);
+            free_.push_back(n);
+        }
+
+        ///
+        /// \brief  Matches the order against the queue at the level, in
+        ///         order of time priority.
+        ///
+        void match_(const limit_order &order, std::uint32_t &remainder_, levels_t::iterator level)
+        {
+            const quote limit_ = level->first;
+            while(0 < remainder_ && no_link != level->second.first){
+                const link matched_ = level->second.first;
+                node &resting_ = nodes_[matched_];
+                auto executed_ = std::min(remainder_, resting_.quantity);
+                remainder_ -= executed_;
+                resting_.quantity -= executed_;
+                level->second.quantity -= executed_;
+
+                report(
+                    execution_report::match,
+                    order.side,
+                    executed_,
+                    direct_order,
+                    limit_,
+                    order.owner
+                );
+
+                report(
+                    execution_report::match,
+                    resting_.side,
+                    executed_, 
+                    resting_.identifier,
+                    limit_,
+                    owners_[resting_.owner]
+                );
+
+                if(0 == resting_.quantity){
+                    // removing the last order removes the level as well
+                    const bool emptied_ = (1 == level->second.orders);
+                    remove_(matched_);
+                    if(emptied_){
+                        return;
+                    }
+                }
+            }
+        }
 
-        std::map<basic_book::order_identifier, quote> limit_orders_;
     public:
         binary_tree_order_book()
         : next_(0)
@@ -64,44 +238,65 @@ namespace esl::economics::markets::order_book {
 
         }
 
-        typedef std::multimap< quote
-                             , std::pair<basic_book::order_identifier , limit_order>
-                             , std::greater<>
-                             > bid_t;
+        ///
+        /// \brief  Resting orders refer to their level by an iterator into
+        ///         `bids` or `asks`, which a copy would not update. Moving
+        ///         keeps the iterators valid.
+        ///
+        binary_tree_order_book(const binary_tree_order_book &) = delete;
+
+        binary_tree_order_book &operator = (const binary_tree_order_book &) = delete;
 
-        typedef std::multimap< quote
-                             , std::pair<basic_book::order_identifier , limit_order>
-                             , std::less<>
-                             > ask_t;
+        binary_tree_order_book(binary_tree_order_book &&) = default;
+
+        binary_tree_order_book &operator = (binary_tree_order_book &&) = default;
 
         /// 
-        /// \brief  All active buy orders ordered by price descending
+        /// \brief  Price levels with active buy orders
         /// 
-        bid_t orders_bid;
+        levels_t bids;
 
         ///
-        /// \brief  All active sell orders ordered by price ascending
+        /// \brief  Price levels with active sell orders
         /// 
-        ask_t orders_ask;
+        levels_t asks;
 
         ///
         /// \brief  The best bid
         /// 
         [[nodiscard]] std::optional<quote> bid() const override
         {
-            if(orders_bid.empty()){
+            if(bids.empty()){
                 return {};
             }
-            return quote(orders_bid.begin()->first);
+            return bids.rbegin()->first;
         }
 
 
         [[nodiscard]] std::optional<quote> ask() const override
         {
-            if(orders_ask.empty()){
+            if(asks.empty()){
                 return {};
             }
-            return quote(orders_ask.begin()->first);
+            return asks.begin()->first;
+        }
+
+        ///
+        /// \brief  The best `levels` price levels on one side
+        ///
+        [[nodiscard]] std::vector<depth_level> depth(limit_order::side_t side, std::size_t levels) const override
+        {
+            std::vector<depth_level> result_;
+            if(limit_order::buy == side){
+                for(auto i = bids.rbegin(); i != bids.rend() && result_.size() < levels; ++i){
+                    result_.push_back({i->first, i->second.quantity, i->second.orders});
+                }
+            }else{
+                for(auto i = asks.begin(); i != asks.end() && result_.size() < levels; ++i){
+                    result_.push_back({i->first, i->second.quantity, i->second.orders});
+                }
+            }
+            return result_;
         }
 
         ///
@@ -110,210 +305,146 @@ namespace esl::economics::markets::order_book {
         /// \param order
         void insert(const limit_order &order) override
         {
-            if(limit_order::side_t::buy == order.side){
-                auto remainder_ = order.quantity;
-
-                std::vector<decltype(orders_ask.begin())> erase_;
-
-                for( auto i = orders_ask.begin()
-                   ; i != orders_ask.end() && order.limit >= i->first
-                   ; ++ i){
-
-                    auto executed_ =
-                        std::min(remainder_, i->second.second.quantity);
-                    remainder_ -= executed_;
+            auto remainder_ = order.quantity;
 
-                    if(0 == executed_) {
-                        break;
-                    }
-
-                    reports.emplace_back(execution_report (
-                        execution_report::match,
-                        order.side,
-                        executed_,
-                        direct_order,
-                        i->second.second.limit,
-                        order.owner
-                    ));
-
-                    i->second.second.quantity -= executed_;
-                    auto matched_identifier_ = i->second.first;
-
-                    reports.emplace_back(execution_report {
-                        execution_report::match,
-                        i->second.second.side,
-                        executed_, 
-                        matched_identifier_,
-                        i->second.second.limit,
-                        i->second.second.owner
-                    });
-
-                    if(0 == i->second.second.quantity){
-                        //orders_ask.erase(i);
-                        //i = orders_ask.begin();
-                        erase_.push_back(i);
-                        limit_orders_.erase(matched_identifier_);
-                    }
-                }
-
-                for(const auto it : erase_) {
-                    orders_ask.erase(it);
-                }
-
-                if(remainder_ > 0) {
-                    // place remainder
-                    limit_order placed_ = order;
-                    placed_.quantity    = remainder_;
-                    auto pair_          = std::make_pair(next_, placed_);
-                    orders_bid.emplace(order.limit, pair_);
-                    limit_orders_.emplace(next_, order.limit);
-                    reports.emplace_back(execution_report {
-                        execution_report::placement,
-                        order.side, 
-                        remainder_,
-                        next_,
-                        order.limit,
-                        order.owner});
-                    ++next_;
+            if(limit_order::side_t::buy == order.side){
+                while(0 < remainder_ && !asks.empty() && order.limit >= asks.begin()->first){
+                    match_(order, remainder_, asks.begin());
                 }
             }else{
-                auto remainder_ = order.quantity;
-
-                std::vector<decltype(orders_bid.begin())> erase_;
-
-                for( auto i = orders_bid.begin()
-                    ; i != orders_bid.end() && order.limit <= i->first
-                    ; ++ i){
-
-                    auto executed_ = std::min(remainder_, i->second.second.quantity);
-                    remainder_ -= executed_;
-
-                    if(0 == executed_) {
-                        break;
-                    }
-
-                    reports.emplace_back(execution_report {
-                        execution_report::match,
-                        order.side,
-                        executed_,
-                        direct_order,
-                        i->second.second.limit,
-                        order.owner
-                    });
-
-                    i->second.second.quantity -= executed_;
-
-                    auto matched_identifier_ = i->second.first;
-
-                    reports.emplace_back(execution_report {
-                        execution_report::match,
-                        i->second.second.side,
-                        executed_,
-                        matched_identifier_,
-                        i->second.second.limit,
-                        i->second.second.owner
-                    });
-
-                    if(0 == i->second.second.quantity){
-                        //
-                        erase_.push_back(i);
-                        limit_orders_.erase(matched_identifier_);
-                        //i = orders_bid.begin();
-                    }
+                while(0 < remainder_ && !bids.empty() && order.limit <= std::prev(bids.end())->first){
+                    match_(order, remainder_, std::prev(bids.end()));
                 }
+            }
 
-                for(const auto it : erase_) {
-                    orders_bid.erase(it);
-                }
+            if(0 == remainder_) {
+                return;
+            }
 
-                if(remainder_ > 0) {
-                    limit_order placed_ = order;
-                    placed_.quantity    = remainder_;
-                    auto pair_          = std::make_pair(next_, placed_);
-                    orders_ask.emplace(order.limit, pair_);
-                    limit_orders_.emplace(next_, order.limit);
-
-                    reports.emplace_back(execution_report {
-                        execution_report::placement,
-                        order.side,
-                        remainder_,
-                        next_,
-                        order.limit,
-                        order.owner});
-                    ++next_;
-                }
+            // place remainder
+            auto &side_ = (limit_order::buy == order.side ? bids : asks);
+            auto level_ = side_.try_emplace(order.limit).first;
+
+            const link placed_ = allocate_();
+            node &node_ = nodes_[placed_];
+            node_.identifier = next_;
+            node_.level = level_;
+            node_.quantity = remainder_;
+            node_.owner = owners_.intern(order.owner);
+            node_.side = order.side;
+            node_.previous = level_->second.last;
+            node_.next = no_link;
+
+            if(no_link == level_->second.last){
+                level_->second.first = placed_;
+            }else{
+                nodes_[level_->second.last].next = placed_;
             }
+            level_->second.last = placed_;
+            level_->second.quantity += remainder_;
+            ++level_->second.orders;
+
+            index_.emplace(next_, placed_);
+
+            report(
+                execution_report::placement,
+                order.side, 
+                remainder_,
+                next_,
+                order.limit,
+                order.owner);
+            ++next_;
         }
 
         /// 
-        /// \brief  
+        /// \brief  Cancels a resting order, orders that were matched or
+        ///         cancelled before are ignored.
         /// 
         void cancel(order_identifier order) override
         {
-            auto o = limit_orders_.find(order);
-             
-            if(limit_orders_.end() != o) {
-                
-                if(bid().has_value() && bid().value() >= o->second) {
-                    // canceled order is a buy
-                    auto [begin_, end_] = orders_bid.equal_range(o->second);
-
-                    for(auto i = begin_; i != end_; ++i) {
-                        if(i->second.first == order) {
-                            reports.emplace_back(execution_report 
-                                { execution_report::cancel
-                                , limit_order::buy
-                                , i->second.second.quantity
-                                , order
-                                , o->second
-                                , i->second.second.owner
-                                });
-                            orders_bid.erase(i);
-                            break;
-                        }
-                    }
+            auto i = index_.find(order);
+            if(index_.end() == i) {
+                return;
+            }
 
-                } else if(ask().has_value() && ask().value() <= o->second) {
-                    // canceled order is a sell
-                    auto [begin_, end_] = orders_ask.equal_range(o->second);
-
-                    for(auto i = begin_; i != end_; ++i) {
-                        if(i->second.first == order) {
-                            reports.emplace_back(execution_report 
-                                { execution_report::cancel
-                                , limit_order::sell
-                                , i->second.second.quantity
-                                , order
-                                , o->second
-                                , i->second.second.owner});
-                            orders_ask.erase(i);
-                            break;
-                        }
-                    }
-                }
+            const node &node_ = nodes_[i->second];
+            report( execution_report::cancel
+                  , node_.side
+                  , node_.quantity
+                  , order
+                  , node_.level->first
+                  , owners_[node_.owner]
+                  );
+            remove_(i->second);
+        }
+
+        using basic_book::insert;
+        using basic_book::cancel;
+
+        ///
+        /// \brief  Inserts a sequence of orders in order of arrival,
+        ///         without a virtual call per order.
+        ///
+        void insert(const limit_order *first, const limit_order *last) override
+        {
+            reserve_reports(static_cast<std::size_t>(last - first));
+            for(; first != last; ++first){
+                binary_tree_order_book::insert(*first);
+            }
+        }
+
+        ///
+        /// \brief  Cancels a sequence of orders in order.
+        ///
+        void cancel(const basic_book::order_identifier *first, const basic_book::order_identifier *last) override
+        {
+            reserve_reports(static_cast<std::size_t>(last - first));
+            for(; first != last; ++first){
+                binary_tree_order_book::cancel(*first);
             }
         }
 
         ///
-        /// \brief  Lists all active orders
+        /// \brief  Lists all active orders, in order of placement
         /// 
         [[nodiscard]] virtual std::vector<typename basic_book::order_identifier> orders() const
         {
-            std::vector<typename basic_book::order_identifier>
-                result_;
-            for(decltype(limit_orders_)::const_iterator i = limit_orders_.begin(); i != limit_orders_.end(); ++i) {
-                result_.push_back(i->first);
+            std::vector<typename basic_book::order_identifier> result_;
+            result_.reserve(index_.size());
+            for(const auto &[identifier_, node_]: index_) {
+                (void) node_;
+                result_.push_back(identifier_);
             }
+            std::sort(result_.begin(), result_.end());
             return result_;
         }
 
         void display(std::uint64_t levels) const override
         {
+            std::cout << "            bid |                | ask            " << std::endl;
+            std::cout << std::setfill(' ');
 
-        }
-
-
+            std::vector<std::pair<std::uint64_t, double>> ask_displayed_;
+            for(auto i = asks.begin(); i != asks.end() && ask_displayed_.size() < levels; ++i){
+                ask_displayed_.emplace_back(i->second.quantity, double(i->first));
+            }
+            for(auto r = ask_displayed_.rbegin(); r != ask_displayed_.rend(); ++r){
+                std::cout << "                | "
+                          << std::left << std::setw(14) << r->second
+                          << " | "
+                          << std::left << std::setw(15) << r->first
+                          << std::endl;
+            }
 
+            std::uint64_t displayed_ = 0;
+            for(auto i = bids.rbegin(); i != bids.rend() && displayed_ < levels; ++i, ++displayed_){
+                std::cout << std::right << std::setw(15) << i->second.quantity
+                          << " | "
+                          << std::left << std::setw(14) << double(i->first)
+                          << " | "
+                          << std::endl;
+            }
+        }
     };
 }  // namespace esl::economics::markets::order_book
 
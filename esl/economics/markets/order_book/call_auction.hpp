@@ -0,0 +1,374 @@
+/// \file   call_auction.hpp
+///
+/// \brief  Collects orders and clears them at a single price, as in the
+///         opening and closing auctions of stock exchanges.
+///
+/// \authors    Maarten P. Scholl
+/// \date       2026-10-17
+/// \copyright  Copyright 2017-2026 The Institute for New Economic Thinking,
+///             Oxford Martin School, University of Oxford
+///
+///             Licensed under the Apache License, Version 2.0 (the "License");
+///             you may not use this file except in compliance with the License.
+///             You may obtain a copy of the License at
+///
+///                 http://www.apache.org/licenses/LICENSE-2.0
+///
+///             Unless required by applicable law or agreed to in writing,
+///             software distributed under the License is distributed on an "AS
+///             IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+///             express or implied. See the License for the specific language
+///             governing permissions and limitations under the License.
+///
+///             You may obtain instructions to fulfill the attribution
+///             requirements in CITATION.cff
+///
+#ifndef ESL_CALL_AUCTION_HPP
+#define ESL_CALL_AUCTION_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include <esl/economics/markets/order_book/basic_book.hpp>
+#include <esl/economics/markets/order_book/execution_report.hpp>
+#include <esl/economics/markets/order_book/order.hpp>
+
+
+namespace esl::economics::markets::order_book {
+
+    ///
+    /// \brief  A call auction: orders are collected without matching, and
+    ///         `clear` executes them at the price that maximises the volume
+    ///         traded.
+    ///
+    class call_auction
+    {
+    public:
+        ///
+        /// \brief  How the quantity at the clearing price is divided when
+        ///         one side has more than can be executed. In both cases
+        ///         orders with a better limit are executed first.
+        ///
+        enum allocation_t
+        { time_priority ///< orders at the marginal limit in order of arrival
+        , pro_rata      ///< orders at the marginal limit in proportion to
+                        ///  their quantity, rounding down, after which the
+                        ///  remaining units go to the earliest orders
+        };
+
+        struct entry
+        {
+            limit_order order;
+
+            basic_book::order_identifier identifier;
+        };
+
+        ///
+        /// \brief  A report, together with the order it applies to
+        ///
+        struct execution
+        {
+            execution_report report;
+
+            limit_order order;
+        };
+
+        struct result
+        {
+            ///
+            /// \brief  The uniform price, if any quantity was executed
+            ///
+            std::optional<quote> price;
+
+            ///
+            /// \brief  Quantity bought, which equals the quantity sold
+            ///
+            std::uint64_t volume = 0;
+
+            std::vector<execution> executions;
+        };
+
+        ///
+        /// \brief  Orders that have not been executed, in order of arrival
+        ///         and therefore of identifier. Cancelled orders are left in
+        ///         place with zero quantity until the next clearing.
+        ///
+        std::vector<entry> orders;
+
+    private:
+        basic_book::order_identifier next_;
+
+        ///
+        /// \brief  Number of cancelled entries in `orders`
+        ///
+        std::size_t cancelled_ = 0;
+
+        ///
+        /// \brief  Removes the cancelled entries, keeping the order of the
+        ///         others
+        ///
+        void compact_()
+        {
+            orders.erase(std::remove_if(orders.begin(), orders.end(), [](const entry &e){
+                return 0 == e.order.quantity;
+            }), orders.end());
+            cancelled_ = 0;
+        }
+
+        ///
+        /// \brief  Executes `volume` of the orders at `positions`, which
+        ///         are sorted by priority
+        ///
+        void allocate_( const std::vector<std::size_t> &positions
+                      , std::uint64_t volume
+                      , allocation_t allocation
+                      , const quote &price
+                      , std::vector<std::uint32_t> &executed
+                      , result &r
+                      ) const
+        {
+            std::size_t first_ = 0;
+            while(first_ < positions.size() && 0 < volume){
+                // the orders sharing the limit of the first order
+                std::size_t last_ = first_;
+                std::uint64_t level_ = 0;
+                const auto &limit_ = orders[positions[first_]].order.limit;
+                while(last_ < positions.size() && orders[positions[last_]].order.limit == limit_){
+                    level_ += orders[positions[last_]].order.quantity;
+                    ++last_;
+                }
+
+                if(level_ <= volume || time_priority == allocation){
+                    for(auto i = first_; i < last_ && 0 < volume; ++i){
+                        auto q = static_cast<std::uint32_t>(std::min<std::uint64_t>(volume, orders[positions[i]].order.quantity));
+                        executed[positions[i]] = q;
+                        volume -= q;
+                    }
+                }else{
+                    std::uint64_t allocated_ = 0;
+                    for(auto i = first_; i < last_; ++i){
+                        auto q = static_cast<std::uint32_t>(orders[positions[i]].order.quantity * volume / level_);
+                        executed[positions[i]] = q;
+                        allocated_ += q;
+                    }
+                    for(auto i = first_; i < last_ && allocated_ < volume; ++i){
+                        if(executed[positions[i]] < orders[positions[i]].order.quantity){
+                            ++executed[positions[i]];
+                            ++allocated_;
+                        }
+                    }
+                    volume = 0;
+                }
+                first_ = last_;
+            }
+
+            for(auto p: positions){
+                if(0 == executed[p]){
+                    continue;
+                }
+                const auto &e = orders[p];
+                r.executions.push_back({execution_report( execution_report::match
+                                                        , e.order.side
+                                                        , executed[p]
+                                                        , e.identifier
+                                                        , price
+                                                        , e.order.owner)
+                                       , e.order});
+            }
+        }
+
+    public:
+        ///
+        /// \param first_identifier identifier of the first order, so that
+        ///                         identifiers can be kept distinct from
+        ///                         those of other books
+        ///
+        explicit call_auction(basic_book::order_identifier first_identifier = 0)
+        : next_(first_identifier)
+        {
+
+        }
+
+        ///
+        /// \return the identifier assigned to the order
+        ///
+        basic_book::order_identifier insert(const limit_order &order)
+        {
+            orders.push_back({order, next_});
+            return next_++;
+        }
+
+        ///
+        /// \brief  Number of orders that have not been executed or cancelled
+        ///
+        [[nodiscard]] std::size_t size() const
+        {
+            return orders.size() - cancelled_;
+        }
+
+        [[nodiscard]] bool empty() const
+        {
+            return orders.size() == cancelled_;
+        }
+
+        ///
+        /// \brief  Finds the order by binary search, and marks it as
+        ///         cancelled. The entry is removed at the next clearing, or
+        ///         once cancelled entries make up half of the orders.
+        ///
+        /// \return the cancellation report and the order, if the order was
+        ///         found
+        ///
+        std::optional<execution> cancel(basic_book::order_identifier identifier)
+        {
+            auto i = std::lower_bound(orders.begin(), orders.end(), identifier, [](const entry &e, basic_book::order_identifier k){
+                return e.identifier < k;
+            });
+            if(orders.end() == i || identifier != i->identifier || 0 == i->order.quantity){
+                return {};
+            }
+            execution result_ {execution_report( execution_report::cancel
+                                               , i->order.side
+                                               , i->order.quantity
+                                               , i->identifier
+                                               , i->order.limit
+                                               , i->order.owner)
+                              , i->order};
+            i->order.quantity = 0;
+            ++cancelled_;
+            if(orders.size() <= 2 * cancelled_){
+                compact_();
+            }
+            return result_;
+        }
+
+        ///
+        /// \brief  Finds the price that maximises the executed volume, with
+        ///         ties broken by the smallest imbalance between demand and
+        ///         supply, then by taking the middle of the remaining
+        ///         candidates. Executes the orders at that price, and
+        ///         removes the orders that are filled.
+        ///
+        result clear(allocation_t allocation = time_priority)
+        {
+            result result_;
+
+            // the price ladder consists of all limits
+            if(0 < cancelled_){
+                compact_();
+            }
+            std::vector<quote> ladder_;
+            ladder_.reserve(orders.size());
+            for(const auto &e: orders){
+                ladder_.push_back(e.order.limit);
+            }
+            std::sort(ladder_.begin(), ladder_.end());
+            ladder_.erase(std::unique(ladder_.begin(), ladder_.end()), ladder_.end());
+            if(ladder_.empty()){
+                return result_;
+            }
+
+            // quantity per rung, then cumulative: supply at a price includes
+            // all sell orders at or below it, demand all buy orders at or
+            // above it
+            std::vector<std::uint64_t> demand_(ladder_.size(), 0);
+            std::vector<std::uint64_t> supply_(ladder_.size(), 0);
+            for(const auto &e: orders){
+                auto k = std::lower_bound(ladder_.begin(), ladder_.end(), e.order.limit) - ladder_.begin();
+                (limit_order::buy == e.order.side ? demand_ : supply_)[k] += e.order.quantity;
+            }
+            for(std::size_t k = 1; k < ladder_.size(); ++k){
+                supply_[k] += supply_[k - 1];
+                demand_[ladder_.size() - 1 - k] += demand_[ladder_.size() - k];
+            }
+
+            std::uint64_t best_volume_ = 0;
+            std::uint64_t best_imbalance_ = 0;
+            std::vector<std::size_t> candidates_;
+            for(std::size_t k = 0; k < ladder_.size(); ++k){
+                auto volume_ = std::min(demand_[k], supply_[k]);
+                auto imbalance_ = std::max(demand_[k], supply_[k]) - volume_;
+                if(volume_ > best_volume_ || (volume_ == best_volume_ && imbalance_ < best_imbalance_)){
+                    best_volume_ = volume_;
+                    best_imbalance_ = imbalance_;
+                    candidates_.clear();
+                }
+                if(volume_ == best_volume_ && imbalance_ == best_imbalance_){
+                    candidates_.push_back(k);
+                }
+            }
+            if(0 == best_volume_){
+                return result_;
+            }
+
+            const auto &price_ = ladder_[candidates_[(candidates_.size() - 1) / 2]];
+            result_.price = price_;
+            result_.volume = best_volume_;
+
+            // executable orders by priority: better limit first, then arrival
+            std::vector<std::size_t> buys_;
+            std::vector<std::size_t> sells_;
+            for(std::size_t i = 0; i < orders.size(); ++i){
+                const auto &o = orders[i].order;
+                if(limit_order::buy == o.side && o.limit >= price_){
+                    buys_.push_back(i);
+                }else if(limit_order::sell == o.side && o.limit <= price_){
+                    sells_.push_back(i);
+                }
+            }
+            std::stable_sort(buys_.begin(), buys_.end(), [&](std::size_t a, std::size_t b){
+                return orders[a].order.limit > orders[b].order.limit;
+            });
+            std::stable_sort(sells_.begin(), sells_.end(), [&](std::size_t a, std::size_t b){
+                return orders[a].order.limit < orders[b].order.limit;
+            });
+
+            std::vector<std::uint32_t> executed_(orders.size(), 0);
+            allocate_(buys_, best_volume_, allocation, price_, executed_, result_);
+            allocate_(sells_, best_volume_, allocation, price_, executed_, result_);
+
+            std::size_t kept_ = 0;
+            for(std::size_t i = 0; i < orders.size(); ++i){
+                orders[i].order.quantity -= executed_[i];
+                if(0 < orders[i].order.quantity){
+                    if(kept_ != i){
+                        orders[kept_] = std::move(orders[i]);
+                    }
+                    ++kept_;
+                }
+            }
+            orders.erase(orders.begin() + kept_, orders.end());
+            return result_;
+        }
+
+        ///
+        /// \brief  Removes all orders, returning a cancellation report for
+        ///         each
+        ///
+        std::vector<execution> cancel_all()
+        {
+            std::vector<execution> result_;
+            result_.reserve(size());
+            for(auto &e: orders){
+                if(0 == e.order.quantity){
+                    continue;
+                }
+                result_.push_back({execution_report( execution_report::cancel
+                                                   , e.order.side
+                                                   , e.order.quantity
+                                                   , e.identifier
+                                                   , e.order.limit
+                                                   , e.order.owner)
+                                  , std::move(e.order)});
+            }
+            orders.clear();
+            cancelled_ = 0;
+            return result_;
+        }
+    };
+
+}  // namespace esl::economics::markets::order_book
+
+#endif  // ESL_CALL_AUCTION_HPP
@@ -106,6 +106,10 @@ namespace esl::economics::markets::order_book {
         }
 
 
+        execution_report(execution_report &&r) = default;
+
+        execution_report &operator = (execution_report &&r) = default;
+
         execution_report &operator = (const execution_report &r)
         {
             state = r.state;
@@ -28,9 +28,11 @@
 #ifndef ME_MATCHING_ENGINE_HPP
 #define ME_MATCHING_ENGINE_HPP
 
+#include <algorithm>
 #include <iostream>
 #include <map>
 #include <queue>
+#include <vector>
 
 #include <boost/container/flat_map.hpp>
 
@@ -46,6 +48,23 @@ namespace esl::economics::markets::order_book {
         std::function<std::shared_ptr<basic_book>(
             void)>
             order_book_factory_;
+
+        ///
+        /// \brief  Orders of a batch, grouped by symbol
+        ///
+        std::vector<std::vector<limit_order>> batches_;
+
+        boost::container::flat_map<ticker, std::size_t> batch_index_;
+
+        basic_book &book_(const ticker &symbol)
+        {
+            auto i = books.find(symbol);
+            if(i == books.end()) {
+                i = books.emplace(symbol, order_book_factory_()).first;
+            }
+            return *(i->second);
+        }
+
     public:
         boost::container::flat_map<ticker, std::shared_ptr<basic_book>> books;
 
@@ -84,6 +103,59 @@ namespace esl::economics::markets::order_book {
             }
         }
 
+        ///
+        /// \brief  Inserts a sequence of orders, preserving the order of
+        ///         arrival within each book. The orders are grouped by
+        ///         symbol, so that every book is looked up once and receives
+        ///         its orders as one batch, also when symbols are
+        ///         interleaved.
+        ///
+        /// \param first   first order in a contiguous sequence
+        /// \param last    one past the last order
+        void insert(const limit_order *first, const limit_order *last)
+        {
+            if(first == last){
+                return;
+            }
+            // the common case of a single symbol needs no copies
+            if(std::all_of(first + 1, last, [first](const limit_order &o){ return o.symbol == first->symbol; })){
+                book_(first->symbol).insert(first, last);
+                return;
+            }
+
+            batch_index_.clear();
+            for(; first != last; ++first){
+                auto [i, inserted_] = batch_index_.try_emplace(first->symbol, batch_index_.size());
+                if(batches_.size() <= i->second){
+                    batches_.emplace_back();
+                }
+                batches_[i->second].push_back(*first);
+            }
+            for(const auto &[symbol_, index_]: batch_index_){
+                auto &batch_ = batches_[index_];
+                book_(symbol_).insert(batch_.data(), batch_.data() + batch_.size());
+                // keeps the capacity for the next batch
+                batch_.clear();
+            }
+        }
+
+        void insert(const std::vector<limit_order> &orders)
+        {
+            insert(orders.data(), orders.data() + orders.size());
+        }
+
+        ///
+        /// \brief  Cancels a sequence of orders in the book for `symbol`
+        ///
+        void cancel( const ticker &symbol
+                   , const std::vector<typename basic_book::order_identifier> &identifiers)
+        {
+            auto i = books.find(symbol);
+            if(books.end() != i){
+                i->second->cancel(identifiers);
+            }
+        }
+
         /*
         ///
         /// \param symbol
@@ -0,0 +1,170 @@
+/// \file   openbook_replay.cpp
+///
+/// \brief
+///
+/// \authors    Maarten P. Scholl
+/// \date       2026-10-17
+/// \copyright  Copyright 2017-2026 The Institute for New Economic Thinking,
+///             Oxford Martin School, University of Oxford
+///
+///             Licensed under the Apache License, Version 2.0 (the "License");
+///             you may not use this file except in compliance with the License.
+///             You may obtain a copy of the License at
+///
+///                 http://www.apache.org/licenses/LICENSE-2.0
+///
+///             Unless required by applicable law or agreed to in writing,
+///             software distributed under the License is distributed on an "AS
+///             IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+///             express or implied. See the License for the specific language
+///             governing permissions and limitations under the License.
+///
+///             You may obtain instructions to fulfill the attribution
+///             requirements in CITATION.cff
+///
+#include "openbook_replay.hpp"
+
+
+namespace esl::economics::markets::order_book {
+
+    openbook_replay::openbook_replay(matching_engine &engine, std::uint32_t lot)
+    : engine(engine)
+    , lot(lot)
+    , symbol_ticker([](const std::string &, std::uint32_t handle){
+        return ticker(identity<law::property>{std::uint64_t(handle)});
+      })
+    {
+
+    }
+
+    const ticker &openbook_replay::ticker_(const data::openbook_symbol_table &symbols, std::uint32_t handle)
+    {
+        while(tickers_.size() <= handle){
+            auto next_ = static_cast<std::uint32_t>(tickers_.size());
+            tickers_.push_back(symbol_ticker(symbols[next_], next_));
+        }
+        return tickers_[handle];
+    }
+
+    std::int64_t openbook_replay::value_(const data::openbook_event &e) const
+    {
+        std::int64_t scale_ = 1;
+        for(std::uint8_t i = 0; i < e.price_scale; ++i){
+            scale_ *= 10;
+        }
+        // the price value is in cents, per lot
+        return std::int64_t(e.price_numerator) * 100 * lot / scale_;
+    }
+
+    void openbook_replay::flush_()
+    {
+        auto first_ = pending_.data();
+        const auto last_ = pending_.data() + pending_.size();
+        auto symbol_ = pending_symbols_.begin();
+        while(first_ != last_){
+            auto run_ = first_ + 1;
+            auto run_symbol_ = symbol_ + 1;
+            while(run_ != last_ && *run_symbol_ == *symbol_){
+                ++run_;
+                ++run_symbol_;
+            }
+
+            engine.insert(first_, run_);
+            auto &book_ = *engine.books.find(first_->symbol)->second;
+            for(const auto &r: book_.reports){
+                if(execution_report::placement == r.state){
+                    auto value_ = std::get<price>(r.limit.type).value;
+                    levels_[{*symbol_, r.side, value_}].emplace_back(r.identifier, r.quantity);
+                }
+            }
+            book_.reports.clear();
+
+            first_ = run_;
+            symbol_ = run_symbol_;
+        }
+        pending_.clear();
+        pending_symbols_.clear();
+    }
+
+    void openbook_replay::remove_(const data::openbook_event &e, const ticker &symbol)
+    {
+        auto level_ = levels_.find({e.symbol, e.side, value_(e)});
+        if(levels_.end() == level_){
+            ++skipped;
+            return;
+        }
+        auto book_ = engine.books.find(symbol);
+        auto &orders_ = level_->second;
+        const bool newest_ = ('C' == e.reason);
+        auto remaining_ = e.quantity;
+
+        while(0 < remaining_ && !orders_.empty()){
+            auto [identifier_, quantity_] = newest_ ? orders_.back() : orders_.front();
+            if(newest_){
+                orders_.pop_back();
+            }else{
+                orders_.pop_front();
+            }
+            book_->second->cancel(identifier_);
+
+            if(quantity_ <= remaining_){
+                remaining_ -= quantity_;
+                continue;
+            }
+            pending_.emplace_back( symbol
+                                 , identity<agent>()
+                                 , e.side
+                                 , quote(price(value_(e), currencies::USD), lot)
+                                 , quantity_ - remaining_
+                                 , limit_order::lifetime_t::good_until_cancelled);
+            pending_symbols_.push_back(e.symbol);
+            remaining_ = 0;
+        }
+        book_->second->reports.clear();
+        if(orders_.empty()){
+            levels_.erase(level_);
+        }
+        flush_();
+        ++removed;
+    }
+
+    void openbook_replay::process( const data::openbook_event *first
+                                 , const data::openbook_event *last
+                                 , const data::openbook_symbol_table &symbols)
+    {
+        for(; first != last; ++first){
+            const auto &e = *first;
+            if((core_session_only && 'O' != e.trading_status) || 0 == e.quantity){
+                ++skipped;
+                continue;
+            }
+
+            const auto &symbol_ = ticker_(symbols, e.symbol);
+            if('O' == e.reason){
+                pending_.emplace_back( symbol_
+                                     , identity<agent>()
+                                     , e.side
+                                     , quote(price(value_(e), currencies::USD), lot)
+                                     , e.quantity
+                                     , limit_order::lifetime_t::good_until_cancelled);
+                pending_symbols_.push_back(e.symbol);
+                ++inserted;
+            }else if('C' == e.reason || 'E' == e.reason){
+                // orders need identifiers before they can be removed
+                flush_();
+                remove_(e, symbol_);
+            }else{
+                ++skipped;
+            }
+        }
+        flush_();
+    }
+
+    std::uint64_t openbook_replay::replay(data::openbook_reader &reader, std::size_t batch_size)
+    {
+        return reader.read([&](const data::openbook_event *first, const data::openbook_event *last){
+            process(first, last, reader.parser.symbols);
+        }, batch_size);
+    }
+
+}  // namespace esl::economics::markets::order_book
@@ -0,0 +1,174 @@
+/// \file   openbook_replay.hpp
+///
+/// \brief  Rebuilds order books from NYSE OpenBook price point updates, by
+///         feeding the updates as batches of limit orders into a
+///         `matching_engine`.
+///
+/// \authors    Maarten P. Scholl
+/// \date       2026-10-17
+/// \copyright  Copyright 2017-2026 The Institute for New Economic Thinking,
+///             Oxford Martin School, University of Oxford
+///
+///             Licensed under the Apache License, Version 2.0 (the "License");
+///             you may not use this file except in compliance with the License.
+///             You may obtain a copy of the License at
+///
+///                 http://www.apache.org/licenses/LICENSE-2.0
+///
+///             Unless required by applicable law or agreed to in writing,
+///             software distributed under the License is distributed on an "AS
+///             IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+///             express or implied. See the License for the specific language
+///             governing permissions and limitations under the License.
+///
+///             You may obtain instructions to fulfill the attribution
+///             requirements in CITATION.cff
+///
+#ifndef ESL_OPENBOOK_REPLAY_HPP
+#define ESL_OPENBOOK_REPLAY_HPP
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <esl/data/format/openbook_reader.hpp>
+#include <esl/economics/currencies.hpp>
+#include <esl/economics/markets/order_book/matching_engine.hpp>
+
+
+namespace esl::economics::markets::order_book {
+
+    ///
+    /// \brief  Replays OpenBook files into a matching engine.
+    ///
+    /// \details    OpenBook reports the change in interest at a price point,
+    ///             not individual orders. New interest ('O') is inserted as a
+    ///             good-until-cancelled order. Cancellations ('C') remove the
+    ///             most recently added interest at the price point, and
+    ///             executions ('E') the oldest, by cancelling the orders this
+    ///             replay placed there. When only part of an order is
+    ///             removed, the remainder is inserted again, which keeps its
+    ///             place for cancellations but moves it to the back of the
+    ///             queue for executions. Updates for multiple events ('X')
+    ///             can not be attributed and are skipped.
+    ///
+    ///             Orders are inserted in batches, and the identifiers of
+    ///             placed orders are read from the books' `reports`, which
+    ///             are cleared. Books with a report sink keep their
+    ///             additions, but removals are skipped.
+    ///
+    class openbook_replay
+    {
+    public:
+        matching_engine &engine;
+
+        ///
+        /// \brief  Lot size of all quotes. Prices are exact when
+        ///         100 * lot is a multiple of 10^price_scale.
+        ///
+        std::uint32_t lot;
+
+        ///
+        /// \brief  Skip updates outside the core trading session
+        ///
+        bool core_session_only = true;
+
+        ///
+        /// \brief  The ticker for a symbol, called once per symbol. By
+        ///         default, symbols are numbered in order of appearance.
+        ///
+        std::function<ticker(const std::string &symbol, std::uint32_t handle)> symbol_ticker;
+
+        ///
+        /// \brief  Number of updates that inserted interest
+        ///
+        std::uint64_t inserted = 0;
+
+        ///
+        /// \brief  Number of updates that removed interest
+        ///
+        std::uint64_t removed = 0;
+
+        ///
+        /// \brief  Number of updates that were filtered or not attributable
+        ///
+        std::uint64_t skipped = 0;
+
+    private:
+        struct level_key
+        {
+            std::uint32_t symbol;
+            limit_order::side_t side;
+            std::int64_t value;
+
+            [[nodiscard]] bool operator == (const level_key &o) const
+            {
+                return symbol == o.symbol && side == o.side && value == o.value;
+            }
+        };
+
+        struct level_hash
+        {
+            std::size_t operator () (const level_key &k) const
+            {
+                return std::hash<std::int64_t>()(k.value)
+                     ^ (std::size_t(k.symbol) << 1 | std::size_t(k.side));
+            }
+        };
+
+        ///
+        /// \brief  Orders placed by this replay at each price point,
+        ///         oldest first, with their remaining quantity
+        ///
+        std::unordered_map< level_key
+                          , std::deque<std::pair<basic_book::order_identifier, std::uint32_t>>
+                          , level_hash> levels_;
+
+        std::vector<ticker> tickers_;
+
+        std::vector<limit_order> pending_;
+
+        ///
+        /// \brief  Symbol handle of each pending order
+        ///
+        std::vector<std::uint32_t> pending_symbols_;
+
+        const ticker &ticker_(const data::openbook_symbol_table &symbols, std::uint32_t handle);
+
+        [[nodiscard]] std::int64_t value_(const data::openbook_event &e) const;
+
+        ///
+        /// \brief  Inserts the pending orders and records where they were
+        ///         placed
+        ///
+        void flush_();
+
+        void remove_(const data::openbook_event &e, const ticker &symbol);
+
+    public:
+        explicit openbook_replay( matching_engine &engine
+                                , std::uint32_t lot = 100 * currencies::USD.denominator
+                                );
+
+        ///
+        /// \brief  Applies a batch of updates in order
+        ///
+        void process( const data::openbook_event *first
+                    , const data::openbook_event *last
+                    , const data::openbook_symbol_table &symbols
+                    );
+
+        ///
+        /// \brief  Reads and applies the whole file
+        ///
+        /// \return number of price point updates read
+        ///
+        std::uint64_t replay(data::openbook_reader &reader, std::size_t batch_size = 4096);
+    };
+
+}  // namespace esl::economics::markets::order_book
+
+#endif  // ESL_OPENBOOK_REPLAY_HPP
@@ -0,0 +1,744 @@
+/// \file   paged_order_book.hpp
+///
+/// \brief  Order book for instruments with a wide band of valid prices, of
+///         which only small regions hold orders at any time.
+///
+/// \authors    Maarten P. Scholl
+/// \date       2026-10-17
+/// \copyright  Copyright 2017-2026 The Institute for New Economic Thinking,
+///             Oxford Martin School, University of Oxford
+///
+///             Licensed under the Apache License, Version 2.0 (the "License");
+///             you may not use this file except in compliance with the License.
+///             You may obtain a copy of the License at
+///
+///                 http://www.apache.org/licenses/LICENSE-2.0
+///
+///             Unless required by applicable law or agreed to in writing,
+///             software distributed under the License is distributed on an "AS
+///             IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+///             express or implied. See the License for the specific language
+///             governing permissions and limitations under the License.
+///
+///             You may obtain instructions to fulfill the attribution
+///             requirements in CITATION.cff
+///
+#ifndef ESL_PAGED_ORDER_BOOK_HPP
+#define ESL_PAGED_ORDER_BOOK_HPP
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+
+#include <esl/economics/markets/order_book/basic_book.hpp>
+#include <esl/economics/markets/order_book/price_codec.hpp>
+#include <esl/economics/markets/order_book/resting_order.hpp>
+#include <esl/computation/block_pool.hpp>
+#include <esl/computation/hierarchical_bitmap.hpp>
+#include <esl/data/log.hpp>
+
+
+namespace esl::economics::markets::order_book {
+
+        ///
+        /// \brief  Order book with one price level per tick in a fixed
+        ///         interval, like `basic_static_order_book`, but the levels
+        ///         are allocated in fixed-size pages when the first order
+        ///         arrives in their range, and released when the last order
+        ///         leaves it.
+        ///
+        /// \details    Only a directory with one pointer per page is allocated
+        ///             for the whole interval. Level access is two array
+        ///             lookups, and the next occupied level is found with the
+        ///             bitmap of the page and a bitmap of occupied pages.
+        ///
+        /// \tparam price_codec_t_  Maps quotes to price levels and back, see
+        ///                         price_codec.hpp.
+        /// \tparam page_bits_      Each page holds 2^page_bits_ levels
+        ///
+        template< typename price_codec_t_ = tick_price_codec
+                , unsigned int page_bits_ = 9
+                >
+        class basic_paged_order_book
+            : public basic_book
+        {
+        public:
+            typedef std::uint32_t quantity_t_;
+
+            ///
+            /// \brief  Index of a price level in the order book
+            ///
+            typedef std::int64_t limit;
+
+            ///
+            /// \brief  Used for the best bid and ask when that side of the
+            ///         book is empty
+            ///
+            constexpr static limit no_level = -1;
+
+            ///
+            /// \brief  Number of price levels in a page
+            ///
+            constexpr static std::size_t page_size = std::size_t(1) << page_bits_;
+
+            static_assert(6 <= page_bits_, "pages hold at least 64 levels");
+
+            ///
+            /// \brief  An abbreviated record for orders in the order book, see
+            ///         `resting_order`.
+            ///
+            typedef resting_order record;
+
+            typedef computation::block_pool::static_block_pool<record> pool_t;
+
+            ///
+            /// \brief
+            ///
+            pool_t pool_;
+
+            typedef typename pool_t::index index;
+
+            typedef computation::block_pool::block<record> *record_pointer;
+
+            [[nodiscard]] record_pointer block_(typename record::link l)
+            {
+                return record::no_link == l ? nullptr : pool_.block_at(l);
+            }
+
+            [[nodiscard]] const computation::block_pool::block<record> *block_(typename record::link l) const
+            {
+                return record::no_link == l ? nullptr : pool_.block_at(l);
+            }
+
+            [[nodiscard]] typename record::link link_(const computation::block_pool::block<record> *b) const
+            {
+                return b ? static_cast<typename record::link>(pool_.position(b)) : record::no_link;
+            }
+
+            ///
+            /// \brief  The first and last order in the queue at a price
+            ///         level, together with the aggregate size of the queue.
+            ///
+            struct limit_type
+            {
+                record_pointer first = nullptr;
+
+                record_pointer second = nullptr;
+
+                ///
+                /// \brief  Total remaining quantity of the orders at this level
+                ///
+                std::uint64_t quantity = 0;
+
+                ///
+                /// \brief  Number of orders at this level
+                ///
+                std::uint32_t orders = 0;
+            };
+
+            ///
+            /// \brief  A contiguous range of `page_size` price levels.
+            ///
+            struct page
+            {
+                std::array<limit_type, page_size> levels;
+
+                ///
+                /// \brief  One bit per level that holds at least one order
+                ///
+                std::array<std::uint64_t, page_size / 64> occupied = {};
+
+                ///
+                /// \brief  Number of levels in the page holding orders
+                ///
+                std::size_t count = 0;
+            };
+
+            ///
+            /// \brief  One entry per page in the valid interval, `nullptr`
+            ///         for pages without orders.
+            ///
+            std::vector<std::unique_ptr<page>> directory_;
+
+            ///
+            /// \brief  Marks the entries in `directory_` that hold orders
+            ///
+            computation::hierarchical_bitmap pages_;
+
+            ///
+            /// \brief  Pages that were released, kept to be reused so that
+            ///         prices oscillating around a page boundary do not
+            ///         allocate.
+            ///
+            std::vector<std::unique_ptr<page>> spare_;
+
+        private:
+            ///
+            /// \brief  Limit prices below the minimum price or above the maximum
+            ///         price are rejected.
+            ///
+            mathematics::interval<quote> valid_limits;
+
+            ///
+            /// \brief  Translates quotes to a position in the book and back
+            ///
+            price_codec_t_ codec_;
+
+            ///
+            /// \brief  Identities of the participants with resting orders
+            ///
+            owner_table owners_;
+
+            ///
+            /// \brief  Number of price levels in the valid interval
+            ///
+            std::size_t span_;
+
+            ///
+            /// \brief  Level of the best bid, or `no_level`
+            ///
+            limit best_bid_;
+
+            ///
+            /// \brief  Level of the best ask, or `no_level`
+            ///
+            limit best_ask_;
+
+            [[nodiscard]] limit_type &at_(limit l)
+            {
+                return directory_[size_t(l) >> page_bits_]->levels[size_t(l) & (page_size - 1)];
+            }
+
+            [[nodiscard]] const limit_type &at_(limit l) const
+            {
+                return directory_[size_t(l) >> page_bits_]->levels[size_t(l) & (page_size - 1)];
+            }
+
+            ///
+            /// \brief  Gets the level, allocating its page if needed
+            ///
+            limit_type &acquire_(limit l)
+            {
+                auto &page_ = directory_[size_t(l) >> page_bits_];
+                if(!page_){
+                    if(spare_.empty()){
+                        page_ = std::make_unique<page>();
+                    }else{
+                        page_ = std::move(spare_.back());
+                        spare_.pop_back();
+                    }
+                }
+                return page_->levels[size_t(l) & (page_size - 1)];
+            }
+
+            void set_occupied_(limit l)
+            {
+                const auto p = size_t(l) >> page_bits_;
+                const auto offset_ = size_t(l) & (page_size - 1);
+                auto &page_ = *directory_[p];
+                page_.occupied[offset_ / 64] |= std::uint64_t(1) << (offset_ % 64);
+                if(0 == page_.count++){
+                    pages_.set(p);
+                }
+            }
+
+            ///
+            /// \brief  Marks an emptied level, releasing its page when no
+            ///         other level in the page holds orders. References to
+            ///         levels in the page are invalid after.
+            ///
+            void reset_occupied_(limit l)
+            {
+                const auto p = size_t(l) >> page_bits_;
+                const auto offset_ = size_t(l) & (page_size - 1);
+                auto &page_ = *directory_[p];
+                page_.occupied[offset_ / 64] &= ~(std::uint64_t(1) << (offset_ % 64));
+                if(0 == --page_.count){
+                    // all levels in the page are empty, so it can be reused
+                    // as it is
+                    pages_.reset(p);
+                    spare_.emplace_back(std::move(directory_[p]));
+                }
+            }
+
+            ///
+            /// \brief  Lowest occupied level at or above `from`
+            ///
+            [[nodiscard]] limit next_(limit from) const
+            {
+                if(from < 0){
+                    from = 0;
+                }
+                if(span_ <= size_t(from)){
+                    return no_level;
+                }
+                auto p = size_t(from) >> page_bits_;
+                if(directory_[p]){
+                    const auto &occupied_ = directory_[p]->occupied;
+                    auto offset_ = size_t(from) & (page_size - 1);
+                    for(auto w = offset_ / 64; w < occupied_.size(); ++w){
+                        auto word_ = occupied_[w];
+                        if(w == offset_ / 64){
+                            word_ &= ~std::uint64_t(0) << (offset_ % 64);
+                        }
+                        if(word_){
+                            return limit((p << page_bits_) + w * 64
+                                        + computation::detail::count_trailing_zeroes(word_));
+                        }
+                    }
+                }
+                p = pages_.next(p + 1);
+                if(computation::hierarchical_bitmap::npos == p){
+                    return no_level;
+                }
+                const auto &occupied_ = directory_[p]->occupied;
+                for(size_t w = 0; ; ++w){
+                    if(occupied_[w]){
+                        return limit((p << page_bits_) + w * 64
+                                    + computation::detail::count_trailing_zeroes(occupied_[w]));
+                    }
+                }
+            }
+
+            ///
+            /// \brief  Highest occupied level at or below `from`
+            ///
+            [[nodiscard]] limit previous_(limit from) const
+            {
+                if(from < 0){
+                    return no_level;
+                }
+                if(span_ <= size_t(from)){
+                    from = limit(span_ - 1);
+                }
+                auto p = size_t(from) >> page_bits_;
+                if(directory_[p]){
+                    const auto &occupied_ = directory_[p]->occupied;
+                    auto offset_ = size_t(from) & (page_size - 1);
+                    for(auto w = offset_ / 64 + 1; 0 < w; --w){
+                        auto word_ = occupied_[w - 1];
+                        if(w - 1 == offset_ / 64){
+                            word_ &= ~std::uint64_t(0) >> (63 - offset_ % 64);
+                        }
+                        if(word_){
+                            return limit((p << page_bits_) + (w - 1) * 64
+                                        + computation::detail::highest_bit(word_));
+                        }
+                    }
+                }
+                if(0 == p){
+                    return no_level;
+                }
+                p = pages_.previous(p - 1);
+                if(computation::hierarchical_bitmap::npos == p){
+                    return no_level;
+                }
+                const auto &occupied_ = directory_[p]->occupied;
+                for(size_t w = occupied_.size(); ; --w){
+                    if(occupied_[w - 1]){
+                        return limit((p << page_bits_) + (w - 1) * 64
+                                    + computation::detail::highest_bit(occupied_[w - 1]));
+                    }
+                }
+            }
+
+            ///
+            /// \brief  Matches an order, partially or fully, against resting
+            ///         orders at a given level in the book
+            ///
+            void match_at_level( const limit_order &order
+                               , std::uint32_t &remainder_
+                               , limit l)
+            {
+                limit_type &level_ = at_(l);
+                const auto quote_ = codec_.decode(l);
+
+                while(0 < remainder_ && level_.first){
+                    auto ao = level_.first;
+                    std::uint32_t execution_size_ = std::min(ao->data.quantity, remainder_);
+                    ao->data.quantity -= execution_size_;
+                    remainder_ -= execution_size_;
+                    level_.quantity -= execution_size_;
+
+                    // execution report for liquidity taker
+                    report( execution_report::match
+                          , order.side
+                          , execution_size_
+                          , basic_book::direct_order
+                          , quote_
+                          , order.owner
+                          );
+
+                    // execution report for supplier
+                    report( execution_report::match
+                          , (order.side == limit_order::sell ? limit_order::buy : limit_order::sell)
+                          , execution_size_
+                          , ao->index
+                          , quote_
+                          , owners_[ao->data.owner]
+                          );
+
+                    if(0 < ao->data.quantity){
+                        break;
+                    }
+
+                    // the highest priority order was exhausted
+                    level_.first = block_(ao->data.successor);
+                    if(level_.first){
+                        level_.first->data.predecessor = record::no_link;
+                    }
+                    --level_.orders;
+                    pool_.erase(ao->index);
+                }
+
+                if(level_.first){
+                    return;
+                }
+
+                level_.second = nullptr;
+                reset_occupied_(l);
+                // the aggressor took away the best level on the other side
+                if(order.side == limit_order::buy){
+                    best_ask_ = next_(l + 1);
+                }else{
+                    best_bid_ = previous_(l - 1);
+                }
+            }
+
+        public:
+            ///
+            /// \param minimum  lowest valid limit price
+            /// \param maximum  highest valid limit price
+            /// \param capacity maximum number of resting orders
+            /// \param slab     orders for which memory is initialized at a
+            ///                 time, 0 initializes memory for `capacity`
+            ///
+            basic_paged_order_book( const quote &minimum
+                                  , const quote &maximum
+                                  , std::uint32_t capacity = 128*1024
+                                  , std::uint32_t slab = 0
+                                  )
+            : basic_book( )
+            , pool_(capacity, slab)
+            , valid_limits(minimum, maximum)
+            , codec_(valid_limits)
+            , span_(0)
+            , best_bid_(no_level)
+            , best_ask_(no_level)
+            {
+                reports.reserve(32);
+                if(valid_limits.empty()){
+                    throw esl::exception("invalid limits specified");
+                }
+                if(minimum.lot != maximum.lot){
+                    throw esl::exception("different lot sizes between minimum and maximum");
+                }
+
+                span_ = codec_.levels();
+                directory_.resize((span_ + page_size - 1) / page_size);
+                pages_.resize(directory_.size());
+            }
+
+            ///
+            /// \brief  Number of pages currently allocated to hold orders
+            ///
+            [[nodiscard]] std::size_t pages() const
+            {
+                std::size_t result_ = 0;
+                for( auto p = pages_.next(0)
+                   ; computation::hierarchical_bitmap::npos != p
+                   ; p = pages_.next(p + 1)){
+                    ++result_;
+                }
+                return result_;
+            }
+
+            ///
+            /// \brief lists all open orders
+            ///
+            [[nodiscard]] std::vector<basic_book::order_identifier> orders() const override
+            {
+                std::vector<basic_book::order_identifier> result_;
+                for(auto l = next_(0); no_level != l; l = next_(l + 1)) {
+                    for(const auto *o = at_(l).first; o; o = block_(o->data.successor)) {
+                        result_.push_back(o->index);
+                    }
+                }
+                return result_;
+            }
+
+            ///
+            /// \brief  Returns the best bid, the highest bid price, if any
+            ///
+            [[nodiscard]] std::optional<quote> bid() const override
+            {
+                if(no_level == best_bid_){
+                    return {};
+                }
+                return codec_.decode(best_bid_);
+            }
+
+            ///
+            /// \brief  Returns the best ask, meaning lowest ask price, if any
+            ///
+            [[nodiscard]] std::optional<quote> ask() const override
+            {
+                if(no_level == best_ask_){
+                    return {};
+                }
+                return codec_.decode(best_ask_);
+            }
+
+            ///
+            /// \brief  The best `levels` price levels on one side, read from
+            ///         the per-level aggregates.
+            ///
+            [[nodiscard]] std::vector<depth_level> depth(limit_order::side_t side, std::size_t levels) const override
+            {
+                std::vector<depth_level> result_;
+                if(limit_order::buy == side){
+                    for( auto l = best_bid_
+                       ; no_level != l && result_.size() < levels
+                       ; l = previous_(l - 1)) {
+                        result_.push_back({codec_.decode(l), at_(l).quantity, at_(l).orders});
+                    }
+                }else{
+                    for( auto l = best_ask_
+                       ; no_level != l && result_.size() < levels
+                       ; l = next_(l + 1)) {
+                        result_.push_back({codec_.decode(l), at_(l).quantity, at_(l).orders});
+                    }
+                }
+                return result_;
+            }
+
+            ///
+            /// \brief
+            ///
+            /// \param order
+            void insert(const limit_order &order) override
+            {
+                limit limit_index_ = 0;
+                if(0 >= order.quantity || order.limit.lot != valid_limits.lower.lot
+                   || !valid_limits.contains(order.limit)
+                   || !codec_.encode(order.limit, limit_index_)
+                   || limit_index_ < 0 || span_ <= size_t(limit_index_)){
+                    LOG(warning) << "Order invalid, limits are " << valid_limits
+                                 << " and the quantity must be positive" << std::endl;
+                    report( execution_report::invalid
+                          , order.side
+                          , order.quantity
+                          , basic_book::direct_order
+                          , order.limit
+                          , order.owner
+                          );
+                    return;
+                }
+
+                std::uint32_t remainder_ = order.quantity;
+
+                if(order.side == limit_order::buy && no_level != best_ask_ && limit_index_ >= best_ask_) {
+                    // direct execution: buyer aggressor
+                    while(0 < remainder_ && no_level != best_ask_ && best_ask_ <= limit_index_){
+                        match_at_level(order, remainder_, best_ask_);
+                    }
+                }else if(order.side == limit_order::sell && no_level != best_bid_ && limit_index_ <= best_bid_) {
+                    // direct execution: seller aggressor
+                    while(0 < remainder_ && no_level != best_bid_ && best_bid_ >= limit_index_){
+                        match_at_level(order, remainder_, best_bid_);
+                    }
+                }else if(order.lifetime == limit_order::lifetime_t::immediate_or_cancel
+                           || order.lifetime == limit_order::lifetime_t::fill_or_kill){
+                    // cancel an immediate/fill order that could not be matched
+                    report( execution_report::cancel
+                          , order.side
+                          , order.quantity
+                          , basic_book::direct_order
+                          , order.limit
+                          , order.owner
+                          );
+                    return;
+                }
+
+                if(0 >= remainder_){
+                    return;
+                }
+                if(order.lifetime == limit_order::lifetime_t::immediate_or_cancel) {
+                    report( execution_report::cancel
+                          , order.side
+                          , remainder_
+                          , basic_book::direct_order
+                          , order.limit
+                          , order.owner
+                          );
+                    return;
+                }
+
+                record record_;
+                record_.level = limit_index_;
+                record_.quantity = remainder_;
+                record_.owner = owners_.intern(order.owner);
+                record_.side = order.side;
+                auto placed_ = pool_.emplace(record_);
+
+                report( execution_report::placement
+                      , order.side
+                      , remainder_
+                      , placed_.first
+                      , order.limit
+                      , order.owner
+                      );
+
+                limit_type &level_ = acquire_(limit_index_);
+                if(!level_.first){
+                    level_.first = placed_.second;
+                    set_occupied_(limit_index_);
+                }else{
+                    level_.second->data.successor = link_(placed_.second);
+                    placed_.second->data.predecessor = link_(level_.second);
+                }
+                level_.second = placed_.second;
+                level_.quantity += remainder_;
+                ++level_.orders;
+
+                if(limit_order::buy == order.side){
+                    best_bid_ = std::max(best_bid_, limit_index_);
+                }else if(no_level == best_ask_ || limit_index_ < best_ask_){
+                    best_ask_ = limit_index_;
+                }
+            }
+
+            ///
+            /// \brief  Cancels an order by the order identifier returned from
+            ///         the order book. Orders that were matched or cancelled
+            ///         before are ignored.
+            ///
+            /// \param order
+            void cancel(basic_book::order_identifier order) override
+            {
+                auto *cancelled_ = pool_.find(order);
+                if(!cancelled_) {
+                    return;
+                }
+
+                record &order_ = cancelled_->data;
+                const limit l = order_.level;
+                limit_type &level_ = at_(l);
+
+                if(record::no_link != order_.predecessor) {
+                    block_(order_.predecessor)->data.successor = order_.successor;
+                }else{
+                    level_.first = block_(order_.successor);
+                }
+
+                if(record::no_link != order_.successor) {
+                    block_(order_.successor)->data.predecessor = order_.predecessor;
+                }else{
+                    level_.second = block_(order_.predecessor);
+                }
+
+                level_.quantity -= order_.quantity;
+                --level_.orders;
+
+                report( execution_report::cancel
+                      , order_.side
+                      , order_.quantity
+                      , order
+                      , codec_.decode(l)
+                      , owners_[order_.owner]
+                      );
+
+                const auto side_ = order_.side;
+                pool_.erase(order);
+
+                if(!level_.first) {
+                    reset_occupied_(l);
+                    if(limit_order::buy == side_ && l == best_bid_) {
+                        best_bid_ = previous_(l - 1);
+                    }else if(limit_order::sell == side_ && l == best_ask_) {
+                        best_ask_ = next_(l + 1);
+                    }
+                }
+            }
+
+            using basic_book::insert;
+            using basic_book::cancel;
+
+            ///
+            /// \brief  Inserts a sequence of orders in order of arrival,
+            ///         without a virtual call per order.
+            ///
+            void insert(const limit_order *first, const limit_order *last) override
+            {
+                reserve_reports(static_cast<std::size_t>(last - first));
+                for(; first != last; ++first){
+                    basic_paged_order_book::insert(*first);
+                }
+            }
+
+            ///
+            /// \brief  Cancels a sequence of orders in order.
+            ///
+            void cancel(const basic_book::order_identifier *first, const basic_book::order_identifier *last) override
+            {
+                reserve_reports(static_cast<std::size_t>(last - first));
+                for(; first != last; ++first){
+                    basic_paged_order_book::cancel(*first);
+                }
+            }
+
+            ///
+            /// \brief  Displays a debugging view for the order book,
+            ///         for use in a terminal/IDE.
+            ///
+            /// \param levels
+            void display(std::uint64_t levels = 5) const override
+            {
+                const auto precision_ = int(std::log10(valid_limits.lower.lot));
+                std::cout << "            bid |                | ask            " << std::endl;
+                std::cout << std::setfill(' ');
+
+                std::vector<std::pair<std::uint64_t, double>> ask_displayed_;
+                for( auto l = next_(best_ask_)
+                   ; no_level != best_ask_ && no_level != l && ask_displayed_.size() < levels
+                   ; l = next_(l + 1)) {
+                    ask_displayed_.emplace_back(at_(l).quantity, double(codec_.decode(l)) * valid_limits.lower.lot);
+                }
+
+                for(auto r = ask_displayed_.rbegin(); r!= ask_displayed_.rend(); ++r){
+                    std::cout << "                | "
+                              << std::left << std::setw(14) << std::setprecision(precision_)
+                              << std::fixed << r->second
+                              << " | "
+                              << std::left << std::setw(15)
+                              << r->first
+                              << std::endl;
+                }
+
+                std::uint64_t displayed_ = 0;
+                for( auto l = previous_(best_bid_)
+                   ; no_level != l && displayed_ < levels
+                   ; l = previous_(l - 1)) {
+                    std::cout << std::right << std::setw(15)
+                              << at_(l).quantity << " | "
+                              << std::left << std::setw(14)
+                              << std::setprecision(precision_)
+                              << double(codec_.decode(l)) * valid_limits.lower.lot
+                              << " | "
+                              << std::endl;
+                    ++displayed_;
+                }
+            }
+        };
+
+        ///
+        /// \brief  The paged order book with integer ticks
+        ///
+        typedef basic_paged_order_book<> paged_order_book;
+}//namespace
+
+#endif  // ESL_PAGED_ORDER_BOOK_HPP
@@ -0,0 +1,155 @@
+/// \file   price_codec.hpp
+///
+/// \brief  Policies that map quotes to price levels in order books that
+///         index orders by an array of price levels.
+///
+/// \authors    Maarten P. Scholl
+/// \date       2026-10-17
+/// \copyright  Copyright 2017-2026 The Institute for New Economic Thinking,
+///             Oxford Martin School, University of Oxford
+///
+///             Licensed under the Apache License, Version 2.0 (the "License");
+///             you may not use this file except in compliance with the License.
+///             You may obtain a copy of the License at
+///
+///                 http://www.apache.org/licenses/LICENSE-2.0
+///
+///             Unless required by applicable law or agreed to in writing,
+///             software distributed under the License is distributed on an "AS
+///             IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+///             express or implied. See the License for the specific language
+///             governing permissions and limitations under the License.
+///
+///             You may obtain instructions to fulfill the attribution
+///             requirements in CITATION.cff
+///
+#ifndef ESL_PRICE_CODEC_HPP
+#define ESL_PRICE_CODEC_HPP
+
+#include <cmath>
+#include <cstdint>
+
+#include <esl/economics/markets/quote.hpp>
+#include <esl/mathematics/interval.hpp>
+
+
+namespace esl::economics::markets::order_book {
+
+    ///
+    /// \brief  Price codecs translate between quotes and the index of a price
+    ///         level, for a fixed interval of valid quotes. A codec provides
+    ///
+    ///             explicit codec(const mathematics::interval<quote> &limits);
+    ///             std::size_t levels() const;
+    ///             bool encode(const quote &q, std::int64_t &out_level) const;
+    ///             quote decode(std::int64_t level) const;
+    ///
+    ///         where levels() is the number of levels needed to cover the
+    ///         interval, and encode returns false for quotes it can not map.
+    ///
+
+    ///
+    /// \brief  Maps quotes to levels by linear interpolation between the
+    ///         lower and upper limit in floating point, using `lot` levels per
+    ///         currency unit per item.
+    ///
+    class interpolated_price_codec
+    {
+    private:
+        mathematics::interval<quote> limits_;
+
+        double lower_;
+
+        double upper_;
+
+        std::size_t levels_;
+
+    public:
+        explicit interpolated_price_codec(const mathematics::interval<quote> &limits)
+        : limits_(limits)
+        , lower_(double(limits.lower))
+        , upper_(double(limits.upper))
+        , levels_(static_cast<std::size_t>(
+              (upper_ - lower_) * limits.lower.lot
+              * std::min(limits.lower.lot, limits.upper.lot) + 1))
+        {
+
+        }
+
+        [[nodiscard]] std::size_t levels() const
+        {
+            return levels_;
+        }
+
+        [[nodiscard]] bool encode(const quote &q, std::int64_t &out_level) const
+        {
+            if(!limits_.contains(q)){
+                return false;
+            }
+
+            out_level = static_cast<std::int64_t>(
+                round((double(q) - lower_) / (upper_ - lower_) * levels_));
+            return true;
+        }
+
+        [[nodiscard]] quote decode(std::int64_t level) const
+        {
+            const auto lot_ = limits_.lower.lot;
+            auto reverse_   = round((double(level) * (upper_ - lower_)) * lot_ * lot_);
+            auto intercept_ = lower_ * lot_ * lot_;
+            return quote((reverse_ / double(levels_ - 1) + intercept_) / lot_, limits_.lower);
+        }
+    };
+
+    ///
+    /// \brief  Maps price quotes to levels using integer arithmetic, with one
+    ///         level for every unit of `price::value` at the lot size of the
+    ///         limits. The mapping is exact and does not round.
+    ///
+    class tick_price_codec
+    {
+    private:
+        std::int64_t lower_;
+
+        std::int64_t upper_;
+
+        iso_4217 valuation_;
+
+        std::uint32_t lot_;
+
+    public:
+        explicit tick_price_codec(const mathematics::interval<quote> &limits)
+        : lower_(std::get<price>(limits.lower.type).value)
+        , upper_(std::get<price>(limits.upper.type).value)
+        , valuation_(std::get<price>(limits.lower.type).valuation)
+        , lot_(limits.lower.lot)
+        {
+            if(limits.lower.lot != limits.upper.lot){
+                throw esl::exception("different lot sizes between minimum and maximum");
+            }
+        }
+
+        [[nodiscard]] std::size_t levels() const
+        {
+            return static_cast<std::size_t>(upper_ - lower_ + 1);
+        }
+
+        [[nodiscard]] bool encode(const quote &q, std::int64_t &out_level) const
+        {
+            const auto *price_ = std::get_if<price>(&q.type);
+            if(!price_ || q.lot != lot_ || price_->valuation != valuation_
+               || price_->value < lower_ || upper_ < price_->value){
+                return false;
+            }
+            out_level = price_->value - lower_;
+            return true;
+        }
+
+        [[nodiscard]] quote decode(std::int64_t level) const
+        {
+            return quote(price(lower_ + level, valuation_), lot_);
+        }
+    };
+}
+
+#endif  // ESL_PRICE_CODEC_HPP
@@ -0,0 +1,248 @@
+/// \file   report_sink.hpp
+///
+/// \brief  Receivers for the execution reports that order books generate,
+///         as an alternative to collecting them in `basic_book::reports`.
+///
+/// \authors    Maarten P. Scholl
+/// \date       2026-10-17
+/// \copyright  Copyright 2017-2026 The Institute for New Economic Thinking,
+///             Oxford Martin School, University of Oxford
+///
+///             Licensed under the Apache License, Version 2.0 (the "License");
+///             you may not use this file except in compliance with the License.
+///             You may obtain a copy of the License at
+///
+///                 http://www.apache.org/licenses/LICENSE-2.0
+///
+///             Unless required by applicable law or agreed to in writing,
+///             software distributed under the License is distributed on an "AS
+///             IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+///             express or implied. See the License for the specific language
+///             governing permissions and limitations under the License.
+///
+///             You may obtain instructions to fulfill the attribution
+///             requirements in CITATION.cff
+///
+#ifndef ESL_REPORT_SINK_HPP
+#define ESL_REPORT_SINK_HPP
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include <esl/economics/markets/order_book/execution_report.hpp>
+#include <esl/exception.hpp>
+
+
+namespace esl::economics::markets::order_book {
+
+    ///
+    /// \brief  Receives the execution reports of an order book as they are
+    ///         generated during matching.
+    ///
+    /// \details    The fields are passed separately, so that a sink that
+    ///             does not keep the report does not construct one, and
+    ///             does not copy the owner's identity.
+    ///
+    struct report_sink
+    {
+        virtual ~report_sink() = default;
+
+        virtual void consume( execution_report::state_t state
+                            , limit_order::side_t side
+                            , std::uint32_t quantity
+                            , std::uint64_t identifier
+                            , const quote &limit
+                            , const identity<agent> &owner
+                            ) = 0;
+    };
+
+    ///
+    /// \brief  Calls a function for every report. The report is only valid
+    ///         for the duration of the call.
+    ///
+    class callback_report_sink
+    : public report_sink
+    {
+    public:
+        typedef std::function<void(const execution_report &)> callback_t;
+
+    private:
+        callback_t callback_;
+
+        ///
+        /// \brief  Reused for every report, so that the owner's identity
+        ///         is copied into existing storage.
+        ///
+        execution_report report_;
+
+    public:
+        explicit callback_report_sink(callback_t callback)
+        : callback_(std::move(callback))
+        {
+
+        }
+
+        void consume( execution_report::state_t state
+                    , limit_order::side_t side
+                    , std::uint32_t quantity
+                    , std::uint64_t identifier
+                    , const quote &limit
+                    , const identity<agent> &owner
+                    ) override
+        {
+            report_.state = state;
+            report_.side = side;
+            report_.quantity = quantity;
+            report_.identifier = identifier;
+            report_.limit = limit;
+            report_.owner = owner;
+            callback_(report_);
+        }
+    };
+
+    ///
+    /// \brief  Keeps the most recent reports in preallocated storage. When
+    ///         full, the oldest report is overwritten.
+    ///
+    /// \details    Slots are assigned in place, so once every slot has held
+    ///             a report with an owner of typical length, consuming a
+    ///             report does not allocate. Reports are read in place with
+    ///             `operator[]`, 0 being the oldest.
+    ///
+    class ring_buffer_report_sink
+    : public report_sink
+    {
+    private:
+        std::vector<execution_report> buffer_;
+
+        ///
+        /// \brief  Position of the oldest report in the buffer
+        ///
+        std::size_t first_;
+
+        std::size_t size_;
+
+    public:
+        ///
+        /// \brief  Number of reports that were overwritten before they were
+        ///         cleared
+        ///
+        std::uint64_t overwritten;
+
+        explicit ring_buffer_report_sink(std::size_t capacity)
+        : buffer_(capacity)
+        , first_(0)
+        , size_(0)
+        , overwritten(0)
+        {
+            if(0 == capacity){
+                throw esl::exception("ring buffer capacity must be positive");
+            }
+        }
+
+        void consume( execution_report::state_t state
+                    , limit_order::side_t side
+                    , std::uint32_t quantity
+                    , std::uint64_t identifier
+                    , const quote &limit
+                    , const identity<agent> &owner
+                    ) override
+        {
+            std::size_t position_ = first_ + size_;
+            if(buffer_.size() <= position_){
+                position_ -= buffer_.size();
+            }
+            if(buffer_.size() == size_){
+                ++overwritten;
+                ++first_;
+                if(buffer_.size() == first_){
+                    first_ = 0;
+                }
+            }else{
+                ++size_;
+            }
+
+            auto &report_ = buffer_[position_];
+            report_.state = state;
+            report_.side = side;
+            report_.quantity = quantity;
+            report_.identifier = identifier;
+            report_.limit = limit;
+            report_.owner = owner;
+        }
+
+        [[nodiscard]] std::size_t size() const
+        {
+            return size_;
+        }
+
+        [[nodiscard]] bool empty() const
+        {
+            return 0 == size_;
+        }
+
+        [[nodiscard]] std::size_t capacity() const
+        {
+            return buffer_.size();
+        }
+
+        ///
+        /// \brief  The i-th oldest report
+        ///
+        [[nodiscard]] const execution_report &operator [] (std::size_t i) const
+        {
+            i += first_;
+            return buffer_[buffer_.size() <= i ? i - buffer_.size() : i];
+        }
+
+        ///
+        /// \brief  Removes all reports, keeping the storage
+        ///
+        void clear()
+        {
+            first_ = 0;
+            size_ = 0;
+        }
+    };
+
+    ///
+    /// \brief  Counts the reports by state and discards them, to measure
+    ///         the throughput of matching alone.
+    ///
+    struct counting_report_sink
+    : public report_sink
+    {
+        ///
+        /// \brief  Number of reports, indexed by `execution_report::state_t`
+        ///
+        std::array<std::uint64_t, 4> reports = {};
+
+        ///
+        /// \brief  Total quantity in match reports, which counts both
+        ///         the aggressor and the resting order
+        ///
+        std::uint64_t matched = 0;
+
+        void consume( execution_report::state_t state
+                    , limit_order::side_t side
+                    , std::uint32_t quantity
+                    , std::uint64_t identifier
+                    , const quote &limit
+                    , const identity<agent> &owner
+                    ) override
+        {
+            (void) side;
+            (void) identifier;
+            (void) limit;
+            (void) owner;
+            ++reports[state];
+            if(execution_report::match == state){
+                matched += quantity;
+            }
+        }
+    };
+}
+
+#endif  // ESL_REPORT_SINK_HPP
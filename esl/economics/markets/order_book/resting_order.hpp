@@ -0,0 +1,141 @@
+/// \file   resting_order.hpp
+///
+/// \brief  Compact representation of orders resting in the order books that
+///         store orders in a memory pool.
+///
+/// \authors    Maarten P. Scholl
+/// \date       2026-10-17
+/// \copyright  Copyright 2017-2026 The Institute for New Economic Thinking,
+///             Oxford Martin School, University of Oxford
+///
+///             Licensed under the Apache License, Version 2.0 (the "License");
+///             you may not use this file except in compliance with the License.
+///             You may obtain a copy of the License at
+///
+///                 http://www.apache.org/licenses/LICENSE-2.0
+///
+///             Unless required by applicable law or agreed to in writing,
+///             software distributed under the License is distributed on an "AS
+///             IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+///             express or implied. See the License for the specific language
+///             governing permissions and limitations under the License.
+///
+///             You may obtain instructions to fulfill the attribution
+///             requirements in CITATION.cff
+///
+#ifndef ESL_RESTING_ORDER_HPP
+#define ESL_RESTING_ORDER_HPP
+
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+#include <esl/economics/markets/order_book/order.hpp>
+#include <esl/simulation/identity.hpp>
+
+
+namespace esl::economics::markets::order_book {
+
+    ///
+    /// \brief  Assigns a small integer to each market participant that has
+    ///         placed an order in the book, so that resting orders do not
+    ///         need to store (and copy) the participant's identity.
+    ///
+    /// \details    Handles are never reused, as the number of participants is
+    ///             small compared to the number of orders.
+    ///
+    class owner_table
+    {
+    public:
+        typedef std::uint32_t handle;
+
+    private:
+        std::unordered_map<identity<agent>, handle> handles_;
+
+        std::vector<identity<agent>> owners_;
+
+    public:
+        ///
+        /// \brief  Gets the handle of the participant, assigning a new handle
+        ///         on first use.
+        ///
+        handle intern(const identity<agent> &owner)
+        {
+            auto i = handles_.find(owner);
+            if(handles_.end() != i){
+                return i->second;
+            }
+            auto result_ = static_cast<handle>(owners_.size());
+            owners_.push_back(owner);
+            handles_.emplace(owner, result_);
+            return result_;
+        }
+
+        ///
+        /// \brief  The participant for a handle returned by `intern`
+        ///
+        [[nodiscard]] const identity<agent> &operator [] (handle h) const
+        {
+            return owners_[h];
+        }
+
+        [[nodiscard]] std::size_t size() const
+        {
+            return owners_.size();
+        }
+    };
+
+    ///
+    /// \brief  An order resting in the book, limited to the fields read while
+    ///         matching. The quote follows from the price level, and the
+    ///         owner is looked up in an `owner_table` only when a report is
+    ///         generated.
+    ///
+    struct resting_order
+    {
+        ///
+        /// \brief  Position of another order in the memory pool
+        ///
+        typedef std::uint32_t link;
+
+        ///
+        /// \brief  Link value for the first and last order in a queue
+        ///
+        constexpr static link no_link = (std::numeric_limits<link>::max)();
+
+        ///
+        /// \brief  Position of the order's price level in the book
+        ///
+        std::int64_t level = 0;
+
+        ///
+        /// \brief  Order quantity remaining
+        ///
+        std::uint32_t quantity = 0;
+
+        ///
+        /// \brief  The market participant that submitted the order
+        ///
+        owner_table::handle owner = 0;
+
+        ///
+        /// \brief  The preceding order in the order-queue
+        ///
+        link predecessor = no_link;
+
+        ///
+        /// \brief  The succeeding order in the order-queue
+        ///
+        link successor = no_link;
+
+        ///
+        /// \brief  Buy or sell
+        ///
+        limit_order::side_t side = limit_order::buy;
+    };
+
+    static_assert(sizeof(resting_order) <= 32, "resting orders fit two to a cache line");
+}
+
+#endif  // ESL_RESTING_ORDER_HPP
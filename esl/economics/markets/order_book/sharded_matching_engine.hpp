@@ -0,0 +1,361 @@
+/// \file   sharded_matching_engine.hpp
+///
+/// \brief  A matching engine that partitions symbols over worker threads.
+///
+/// \authors    Maarten P. Scholl
+/// \date       2026-10-17
+/// \copyright  Copyright 2017-2026 The Institute for New Economic Thinking,
+///             Oxford Martin School, University of Oxford
+///
+///             Licensed under the Apache License, Version 2.0 (the "License");
+///             you may not use this file except in compliance with the License.
+///             You may obtain a copy of the License at
+///
+///                 http://www.apache.org/licenses/LICENSE-2.0
+///
+///             Unless required by applicable law or agreed to in writing,
+///             software distributed under the License is distributed on an "AS
+///             IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+///             express or implied. See the License for the specific language
+///             governing permissions and limitations under the License.
+///
+///             You may obtain instructions to fulfill the attribution
+///             requirements in CITATION.cff
+///
+#ifndef ESL_SHARDED_MATCHING_ENGINE_HPP
+#define ESL_SHARDED_MATCHING_ENGINE_HPP
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+#include <boost/container/flat_map.hpp>
+
+#include <esl/computation/spsc_queue.hpp>
+#include <esl/economics/markets/order_book/binary_tree_order_book.hpp>
+#include <esl/economics/markets/order_book/execution_report.hpp>
+#include <esl/economics/markets/ticker.hpp>
+
+
+namespace esl::economics::markets::order_book {
+
+    ///
+    /// \brief  Matches orders for different symbols in parallel. Every
+    ///         symbol is assigned to one shard, which owns the symbol's book
+    ///         and a worker thread that receives orders through a
+    ///         single-producer single-consumer queue.
+    ///
+    /// \details    Orders and cancellations must be submitted from one
+    ///             thread. Each is numbered on submission, and the reports
+    ///             it generates are tagged with that number, so that
+    ///             `synchronize` can merge the reports of all shards in
+    ///             submission order. Books that have a report sink call it
+    ///             from their shard's worker thread.
+    ///
+    class sharded_matching_engine
+    {
+    public:
+        typedef std::function<std::shared_ptr<basic_book>(void)> factory_t;
+
+        ///
+        /// \brief  An execution report, with the symbol of the book and the
+        ///         submission number of the order or cancellation that
+        ///         caused it
+        ///
+        struct sequenced_report
+        {
+            std::uint64_t sequence;
+
+            ticker symbol;
+
+            execution_report report;
+        };
+
+        ///
+        /// \brief  Reports merged by the last call to `synchronize`
+        ///
+        std::vector<sequenced_report> reports;
+
+    private:
+        struct command
+        {
+            std::uint64_t sequence = 0;
+
+            ///
+            /// \brief  For cancellations, the order's symbol is used
+            ///
+            limit_order order;
+
+            basic_book::order_identifier cancel = basic_book::direct_order;
+        };
+
+        struct shard
+        {
+            computation::spsc_queue<command> inbound;
+
+            boost::container::flat_map<ticker, std::shared_ptr<basic_book>> books;
+
+            ///
+            /// \brief  Written by the worker, read after `synchronize`
+            ///
+            std::vector<sequenced_report> outbound;
+
+            ///
+            /// \brief  Number of commands submitted, only used by the
+            ///         submitting thread
+            ///
+            std::uint64_t submitted = 0;
+
+            std::atomic<std::uint64_t> processed = 0;
+
+            ///
+            /// \brief  Set by the worker before it waits for work
+            ///
+            std::atomic<bool> sleeping = false;
+
+            std::mutex mutex;
+
+            std::condition_variable wake;
+
+            std::thread worker;
+
+            explicit shard(std::size_t capacity)
+            : inbound(capacity)
+            {
+
+            }
+        };
+
+        factory_t order_book_factory_;
+
+        std::vector<std::unique_ptr<shard>> shards_;
+
+        std::atomic<bool> stopped_;
+
+        std::uint64_t sequence_;
+
+        ///
+        /// \brief  Number of empty polls before a worker waits
+        ///
+        constexpr static unsigned int spin_ = 1024;
+
+        void work_(shard &s)
+        {
+            command command_;
+            unsigned int idle_ = 0;
+            while(true){
+                if(!s.inbound.try_pop(command_)){
+                    if(stopped_.load(std::memory_order_acquire)){
+                        // orders submitted before stopping are visible now
+                        if(s.inbound.empty()){
+                            return;
+                        }
+                        continue;
+                    }
+                    if(++idle_ < spin_){
+                        std::this_thread::yield();
+                        continue;
+                    }
+                    // the timeout bounds the delay of a missed notification
+                    std::unique_lock<std::mutex> lock_(s.mutex);
+                    s.sleeping.store(true);
+                    if(s.inbound.empty() && !stopped_.load()){
+                        s.wake.wait_for(lock_, std::chrono::milliseconds(1));
+                    }
+                    s.sleeping.store(false);
+                    continue;
+                }
+                idle_ = 0;
+
+                auto i = s.books.find(command_.order.symbol);
+                if(basic_book::direct_order == command_.cancel){
+                    if(s.books.end() == i){
+                        i = s.books.emplace(command_.order.symbol, order_book_factory_()).first;
+                    }
+                    i->second->insert(command_.order);
+                }else if(s.books.end() != i){
+                    i->second->cancel(command_.cancel);
+                }
+
+                if(s.books.end() != i){
+                    for(auto &r: i->second->reports){
+                        s.outbound.push_back({command_.sequence, command_.order.symbol, std::move(r)});
+                    }
+                    i->second->reports.clear();
+                }
+                s.processed.fetch_add(1, std::memory_order_release);
+            }
+        }
+
+        shard &shard_(const ticker &symbol)
+        {
+            return *shards_[std::hash<ticker>()(symbol) % shards_.size()];
+        }
+
+        void submit_(shard &s, command &&c)
+        {
+            c.sequence = sequence_++;
+            while(!s.inbound.try_push(std::move(c))){
+                std::this_thread::yield();
+            }
+            ++s.submitted;
+            if(s.sleeping.load()){
+                std::lock_guard<std::mutex> lock_(s.mutex);
+                s.wake.notify_one();
+            }
+        }
+
+    public:
+        ///
+        /// \param shards           number of worker threads
+        /// \param order_book_factory   called from the worker threads
+        /// \param queue_capacity   orders that can be queued per shard, a
+        ///                         power of two
+        ///
+        explicit sharded_matching_engine
+            ( unsigned int shards = std::thread::hardware_concurrency()
+            , factory_t order_book_factory = [](){
+                    return std::make_shared<binary_tree_order_book>();
+                }
+            , std::size_t queue_capacity = 64 * 1024
+            )
+        : order_book_factory_(std::move(order_book_factory))
+        , stopped_(false)
+        , sequence_(0)
+        {
+            // hardware_concurrency is not guaranteed to work well on any OS
+            if(0 == shards){
+                shards = 1;
+            }
+            for(unsigned int i = 0; i < shards; ++i){
+                shards_.emplace_back(std::make_unique<shard>(queue_capacity));
+            }
+            for(auto &s: shards_){
+                s->worker = std::thread([this, p = s.get()](){ work_(*p); });
+            }
+        }
+
+        sharded_matching_engine(const sharded_matching_engine &) = delete;
+
+        sharded_matching_engine &operator = (const sharded_matching_engine &) = delete;
+
+        ///
+        /// \brief  Processes the remaining orders, then stops the workers
+        ///
+        ~sharded_matching_engine()
+        {
+            stopped_.store(true, std::memory_order_release);
+            for(auto &s: shards_){
+                {
+                    std::lock_guard<std::mutex> lock_(s->mutex);
+                    s->wake.notify_one();
+                }
+                s->worker.join();
+            }
+        }
+
+        [[nodiscard]] std::size_t shards() const
+        {
+            return shards_.size();
+        }
+
+        ///
+        /// \brief  The shard that matches orders for `symbol`
+        ///
+        [[nodiscard]] std::size_t shard_index(const ticker &symbol) const
+        {
+            return std::hash<ticker>()(symbol) % shards_.size();
+        }
+
+        void insert(const limit_order &order)
+        {
+            command command_;
+            command_.order = order;
+            submit_(shard_(order.symbol), std::move(command_));
+        }
+
+        void insert(const limit_order *first, const limit_order *last)
+        {
+            for(; first != last; ++first){
+                insert(*first);
+            }
+        }
+
+        void insert(const std::vector<limit_order> &orders)
+        {
+            insert(orders.data(), orders.data() + orders.size());
+        }
+
+        void cancel(const ticker &symbol, basic_book::order_identifier identifier)
+        {
+            command command_;
+            command_.order.symbol = symbol;
+            command_.cancel = identifier;
+            submit_(shard_(symbol), std::move(command_));
+        }
+
+        ///
+        /// \brief  Waits until all submitted orders are processed, and
+        ///         replaces `reports` by the reports generated since the
+        ///         last call, in submission order.
+        ///
+        void synchronize()
+        {
+            for(auto &s: shards_){
+                while(s->processed.load(std::memory_order_acquire) != s->submitted){
+                    std::this_thread::yield();
+                }
+            }
+
+            // each shard's reports are in submission order, and every
+            // submission goes to a single shard
+            reports.clear();
+            typedef std::pair<std::uint64_t, std::size_t> head_t;
+            std::priority_queue<head_t, std::vector<head_t>, std::greater<>> heads_;
+            std::vector<std::size_t> positions_(shards_.size(), 0);
+            for(std::size_t i = 0; i < shards_.size(); ++i){
+                if(!shards_[i]->outbound.empty()){
+                    heads_.emplace(shards_[i]->outbound.front().sequence, i);
+                }
+            }
+            while(!heads_.empty()){
+                auto i = heads_.top().second;
+                heads_.pop();
+                auto &outbound_ = shards_[i]->outbound;
+                auto &position_ = positions_[i];
+                const auto sequence_ = outbound_[position_].sequence;
+                do{
+                    reports.push_back(std::move(outbound_[position_]));
+                    ++position_;
+                }while(position_ < outbound_.size() && sequence_ == outbound_[position_].sequence);
+                if(position_ < outbound_.size()){
+                    heads_.emplace(outbound_[position_].sequence, i);
+                }
+            }
+            for(auto &s: shards_){
+                s->outbound.clear();
+            }
+        }
+
+        ///
+        /// \brief  The book for `symbol`, or nullptr if no order was
+        ///         submitted for it. Only safe to use after `synchronize`,
+        ///         and before submitting more orders.
+        ///
+        [[nodiscard]] std::shared_ptr<basic_book> book(const ticker &symbol) const
+        {
+            const auto &books_ = shards_[shard_index(symbol)]->books;
+            auto i = books_.find(symbol);
+            return books_.end() == i ? nullptr : i->second;
+        }
+    };
+
+}  // namespace esl::economics::markets::order_book
+
+#endif  // ESL_SHARDED_MATCHING_ENGINE_HPP
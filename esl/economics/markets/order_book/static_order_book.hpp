@@ -28,50 +28,40 @@
 #include <cstdint>
 
 #include <esl/economics/markets/order_book/basic_book.hpp>
+#include <esl/economics/markets/order_book/price_codec.hpp>
+#include <esl/economics/markets/order_book/resting_order.hpp>
 #include <esl/computation/block_pool.hpp>
+#include <esl/computation/hierarchical_bitmap.hpp>
 #include <esl/data/log.hpp>
 
 
 namespace esl::economics::markets::order_book {
 
-        
-        class static_order_book 
+        ///
+        /// \brief  Order book that preallocates one price level per tick in
+        ///         a fixed interval, and stores orders in a memory pool.
+        ///
+        /// \tparam price_codec_t_  Maps quotes to price levels and back, see
+        ///                         price_codec.hpp. The codec is called
+        ///                         directly on the matching path.
+        ///
+        template<typename price_codec_t_ = interpolated_price_codec>
+        class basic_static_order_book
             : public basic_book 
         {
         public:
             typedef std::uint32_t quantity_t_;
 
             ///
-            /// \brief  An abbreviated record for orders in the order book.
+            /// \brief  Index of a price level in the order book
             ///
-            ///
-            struct record
-            {
-                ///
-                /// \brief
-                ///
-                quote limit;
-
-                ///
-                /// \brief  Order quantity remaining
-                ///
-                quantity_t_ quantity = 0;
-
-                ///
-                /// \brief  The market participant that submitted the order.
-                ///
-                identity<agent> owner;
-
-                ///
-                /// \brief  Pointer to the block containing the preceding order in the order-queue
-                ///
-                computation::block_pool::block<record> *predecessor = nullptr;
+            typedef std::int64_t limit;
 
-                ///
-                /// \brief  Pointer to the block containing the succeeding order in the order-queue
-                ///
-                computation::block_pool::block<record> *successor = nullptr;
-            };
+            ///
+            /// \brief  An abbreviated record for orders in the order book, see
+            ///         `resting_order`.
+            ///
+            typedef resting_order record;
 
             typedef computation::block_pool::static_block_pool<record> pool_t;
 
@@ -83,19 +73,58 @@ namespace esl::economics::markets::order_book {
         public:
             typedef typename pool_t::index index;
 
-            typedef std::int64_t limit;
-
             ///
             /// \brief  Used by the data-structure index the memory pool.
             ///
             typedef computation::block_pool::block<record> *record_pointer;
 
+            ///
+            /// \brief  The block a link in a record points to, or `nullptr`
+            ///
+            [[nodiscard]] record_pointer block_(typename record::link l)
+            {
+                return record::no_link == l ? nullptr : pool_.block_at(l);
+            }
+
+            [[nodiscard]] const computation::block_pool::block<record> *block_(typename record::link l) const
+            {
+                return record::no_link == l ? nullptr : pool_.block_at(l);
+            }
+
+            [[nodiscard]] typename record::link link_(const computation::block_pool::block<record> *b) const
+            {
+                return b ? static_cast<typename record::link>(pool_.position(b)) : record::no_link;
+            }
+
             ///
             /// \brief  Used by the data-structure to index the most competitive
             ///         order, and the order at the end of the queue at the
-            ///         given limit price.
+            ///         given limit price, together with the aggregate size of
+            ///         the queue.
             ///
-            typedef std::pair<record_pointer, record_pointer> limit_type;
+            struct limit_type
+            {
+                ///
+                /// \brief  The most competitive order, `nullptr` if the level
+                ///         is empty
+                ///
+                record_pointer first = nullptr;
+
+                ///
+                /// \brief  The order at the end of the queue
+                ///
+                record_pointer second = nullptr;
+
+                ///
+                /// \brief  Total remaining quantity of the orders at this level
+                ///
+                std::uint64_t quantity = 0;
+
+                ///
+                /// \brief  Number of orders at this level
+                ///
+                std::uint32_t orders = 0;
+            };
 
             ///
             /// \brief  Datastructure used to match price levels to orders.
@@ -106,6 +135,13 @@ namespace esl::economics::markets::order_book {
             ///
             std::vector<limit_type> limits_;
 
+            ///
+            /// \brief  Marks the levels in `limits_` that hold at least one
+            ///         order, so that the next best level is found without
+            ///         scanning the empty levels in between.
+            ///
+            computation::hierarchical_bitmap occupied_;
+
         private:
             ///
             /// \brief  Limit prices below the minimum price or above the maximum
@@ -114,6 +150,17 @@ namespace esl::economics::markets::order_book {
             ///
             mathematics::interval<quote> valid_limits;
 
+            ///
+            /// \brief  Translates quotes to a position in the data structure
+            ///         and back.
+            ///
+            price_codec_t_ codec_;
+
+            ///
+            /// \brief  Identities of the participants with resting orders
+            ///
+            owner_table owners_;
+
             ///
             /// \brief  pointer into the `limits_` datastructure to the best
             ///         bid offer. Takes `nullptr` value when buy side of the
@@ -130,26 +177,40 @@ namespace esl::economics::markets::order_book {
             limit_type *best_ask_;
 
             ///
-            /// \brief  Used to translate quotes to a position in the data
-            ///         structure.
-            /// \returns    Success is communicated by the return value `true`.
+            /// \brief  When there are no bids, best_bid_ rests on the lowest
+            ///         level which may hold asks, and vice versa for best_ask_
             ///
-            std::function<bool(const mathematics::interval<quote> &limits, const quote &quote, limit &out_limit)> encode;
+            [[nodiscard]] bool has_bid_() const
+            {
+                return best_bid_->first && limit_order::buy == best_bid_->first->data.side;
+            }
+
+            [[nodiscard]] bool has_ask_() const
+            {
+                return best_ask_->first && limit_order::sell == best_ask_->first->data.side;
+            }
 
             ///
-            /// \brief  Used to get the associated quote from a position in the
-            ///             data-structure.
+            /// \brief  Moves `best_ask_` to the first non-empty level at or
+            ///         above `from`, or to the back of the book if none.
             ///
-            std::function<quote(const mathematics::interval<quote> &limits, const limit &limit)> decode;
+            void seek_best_ask_(limit from)
+            {
+                auto found_ = occupied_.next(static_cast<size_t>(from));
+                best_ask_ = (computation::hierarchical_bitmap::npos == found_)
+                          ? &limits_.back() : &limits_[found_];
+            }
 
             ///
-            /// \brief  Computes the required number of tick levels
-            /// \return
-            size_t span(size_t lot, size_t ticks) const
+            /// \brief  Moves `best_bid_` to the first non-empty level at or
+            ///         below `from`, or to the front of the book if none.
+            ///
+            void seek_best_bid_(limit from)
             {
-                return static_cast<size_t>(
-                    (double(valid_limits.upper) - double(valid_limits.lower)) * lot
-                    * ticks + 1);
+                auto found_ = (0 > from) ? computation::hierarchical_bitmap::npos
+                                         : occupied_.previous(static_cast<size_t>(from));
+                best_bid_ = (computation::hierarchical_bitmap::npos == found_)
+                          ? &limits_.front() : &limits_[found_];
             }
 
         public:
@@ -161,29 +222,34 @@ namespace esl::economics::markets::order_book {
             std::uint32_t ticks;
 
             ///
-            /// \brief  The default encoding function
+            /// \brief  Translates a quote to a position in the data structure.
+            ///
+            /// \returns    Success is communicated by the return value `true`.
+            ///
+            bool encode(const mathematics::interval<quote> &limits, const quote &q, limit &out_limit) const
+            {
+                return price_codec_t_(limits).encode(q, out_limit);
+            }
+
+            ///
+            /// \brief  Gets the associated quote from a position in the
+            ///         data-structure.
+            ///
+            quote decode(const mathematics::interval<quote> &limits, const limit &limit) const
+            {
+                return price_codec_t_(limits).decode(limit);
+            }
+
+            ///
+            /// \brief  The default encoding function, which interpolates
+            ///         between the limits in floating point.
             ///
             /// \param q
             /// \param out_limit
             /// \return
-            /*C++20 constexpr*/  bool default_encode(const mathematics::interval<quote> &limits, const quote &q, limit &out_limit)
+            bool default_encode(const mathematics::interval<quote> &limits, const quote &q, limit &out_limit) const
             {
-                if(!limits.contains(q)){
-                    return false;
-                }
-
-                const auto real_ = double(q);
-
-                const auto high_ = double(limits.upper);
-                const auto low_  = double(limits.lower);
-
-                out_limit = static_cast<limit>(
-                    round(
-                    (real_ - low_)
-                    / (high_ - low_)
-                    * limits_.size())
-                );
-                return true;
+                return interpolated_price_codec(limits).encode(q, out_limit);
             }
 
             ///
@@ -191,15 +257,9 @@ namespace esl::economics::markets::order_book {
             ///
             /// \param limit
             /// \return
-            /*C++20 constexpr*/ quote default_decode(const mathematics::interval<quote> &limits, const limit &limit)
+            quote default_decode(const mathematics::interval<quote> &limits, const limit &limit) const
             {
-                auto high_ = double(valid_limits.upper);
-                auto low_  = double(valid_limits.lower);
-
-                auto reverse = round((double(limit) * (high_ - low_)) * limits.lower.lot * limits.lower.lot);
-
-                auto intercept_ = low_ * limits.lower.lot * limits.lower.lot;
-                return quote( (reverse/ double(limits_.size()-1) +  intercept_) / limits.lower.lot, valid_limits.lower);
+                return interpolated_price_codec(limits).decode(limit);
             }
 
             ///
@@ -211,14 +271,18 @@ namespace esl::economics::markets::order_book {
             /// \param minimum
             /// \param maximum
             /// \param capacity
-            ///
-            static_order_book(const quote &minimum
-                             , const quote &maximum
-                             , std::uint32_t capacity = 128*1024
-                             )
+            /// \param slab     orders for which memory is initialized at a
+            ///                 time, 0 initializes memory for `capacity`
+            ///
+            basic_static_order_book( const quote &minimum
+                                   , const quote &maximum
+                                   , std::uint32_t capacity = 128*1024
+                                   , std::uint32_t slab = 0
+                                   )
             : basic_book( )
-            , pool_(capacity)
+            , pool_(capacity, slab)
             , valid_limits(minimum, maximum)
+            , codec_(valid_limits)
             , ticks(std::min(static_cast<std::uint32_t >(minimum.lot),
                              static_cast<std::uint32_t>(maximum.lot)))
             {
@@ -231,49 +295,236 @@ namespace esl::economics::markets::order_book {
                     throw esl::exception("different lot sizes between minimum and maximum");
                 }
 
-                // +1 because the maximum value is included
-                auto span_ = span(minimum.lot, ticks);
+                // includes the maximum value
+                auto span_ = codec_.levels();
                 // since nullptr is used in the logic of the datastructure,
                 //  we make sure to set this explicitly
-                limits_.resize(span_, std::make_pair(nullptr, nullptr));
+                limits_.resize(span_, limit_type());
+                occupied_.resize(span_);
 
                 best_bid_ = &limits_.front();
                 best_ask_ = &limits_.back();
+            }
 
-                encode = [&](const mathematics::interval<quote> &limits, const auto &q, auto &l) -> bool {
-                    return default_encode(limits, q, l);
-                };
+            ///
+            /// \brief  Determines if and how the valid interval follows the
+            ///         market when orders arrive outside of it.
+            ///
+            struct recentre_policy
+            {
+                ///
+                /// \brief  When false, orders outside the valid interval are
+                ///         rejected as invalid.
+                ///
+                bool enabled = false;
 
-                decode = [&](const mathematics::interval<quote> &limits, const auto &l) -> quote {
-                    return default_decode(limits, l);
-                };
-            }
+                ///
+                /// \brief  When the resting orders and the new order do not fit
+                ///         in the current width, the width is set to their
+                ///         range multiplied by this factor.
+                ///
+                double growth = 2.;
+
+                ///
+                /// \brief  Upper bound on the number of price levels, orders
+                ///         that would require more are rejected. 0 means
+                ///         unbounded.
+                ///
+                std::size_t maximum_levels = 0;
+            };
+
+            ///
+            /// \brief  Orders outside the valid interval are rejected, unless
+            ///         enabled here.
+            ///
+            recentre_policy recentring;
 
             ///
             /// \brief  Resize the order book when market prices move outside of
             ///         the allowed range.
             ///
-            /// \details    This operation is costly, and must be avoided by
-            ///             choosing sensible limits for minimum and maximum
-            ///             allowed prices.
-            ///
+            /// \details    Resting orders stay in the memory pool, only the
+            ///             price levels are laid out again. Orders at levels
+            ///             outside the new interval are cancelled. The cost is
+            ///             linear in the number of levels and resting orders,
+            ///             so when done by `recentre_` the width is chosen
+            ///             such that this happens infrequently.
             ///
             /// \param new_limits
             void resize(const mathematics::interval<quote> &new_limits)
             {
-                // this is a naive implementation, that may hit memory limits
-                // quickly (worst case, resizing from n to size m, it uses n+m
-                // while resizing).
+                if(new_limits.empty()){
+                    throw esl::exception("invalid limits specified");
+                }
+                if(new_limits.lower.lot != valid_limits.lower.lot
+                   || new_limits.upper.lot != valid_limits.lower.lot){
+                    throw esl::exception("different lot sizes between minimum and maximum");
+                }
 
-                throw esl::exception("not implemented");
+                price_codec_t_ codec_resized_(new_limits);
+                std::vector<limit_type> limits_resized_(codec_resized_.levels());
+                computation::hierarchical_bitmap occupied_resized_(limits_resized_.size());
+
+                const bool has_bid_before_ = has_bid_();
+                const bool has_ask_before_ = has_ask_();
+                const auto best_bid_before_ = static_cast<size_t>(best_bid_ - &limits_[0]);
+                const auto best_ask_before_ = static_cast<size_t>(best_ask_ - &limits_[0]);
+                // the levels the best bid and ask are moved to, if retained
+                auto best_bid_resized_ = computation::hierarchical_bitmap::npos;
+                auto best_ask_resized_ = computation::hierarchical_bitmap::npos;
+                bool best_bid_above_ = false;
+                bool best_ask_above_ = false;
+
+                for( auto l = occupied_.next(0)
+                   ; computation::hierarchical_bitmap::npos != l
+                   ; l = occupied_.next(l + 1)) {
+                    limit_type &level_ = limits_[l];
+                    const quote quote_ = codec_.decode(static_cast<limit>(l));
+
+                    limit target_ = 0;
+                    if(!new_limits.contains(quote_)
+                        || !codec_resized_.encode(quote_, target_)
+                        || target_ < 0
+                        || limits_resized_.size() <= static_cast<size_t>(target_)){
+                        // the level falls outside the new interval
+                        for(auto o = level_.first; o; ){
+                            auto successor_ = block_(o->data.successor);
+                            report( execution_report::cancel
+                                  , o->data.side
+                                  , o->data.quantity
+                                  , o->index
+                                  , quote_
+                                  , owners_[o->data.owner]
+                                  );
+                            pool_.erase(o->index);
+                            o = successor_;
+                        }
+                        best_bid_above_ |= (l == best_bid_before_ && new_limits.upper < quote_);
+                        best_ask_above_ |= (l == best_ask_before_ && new_limits.upper < quote_);
+                        continue;
+                    }
+
+                    for(auto o = level_.first; o; o = block_(o->data.successor)){
+                        o->data.level = target_;
+                    }
 
-                std::vector<limit_type> new_limits_;
+                    limit_type &resized_ = limits_resized_[target_];
+                    if(!resized_.first){
+                        resized_ = level_;
+                    }else{
+                        // two levels map to the same price, the orders from the
+                        // lower level keep priority
+                        resized_.second->data.successor = link_(level_.first);
+                        level_.first->data.predecessor = link_(resized_.second);
+                        resized_.second = level_.second;
+                        resized_.quantity += level_.quantity;
+                        resized_.orders += level_.orders;
+                    }
+                    occupied_resized_.set(static_cast<size_t>(target_));
 
-                // TODO: implement
+                    if(l == best_bid_before_){
+                        best_bid_resized_ = static_cast<size_t>(target_);
+                    }
+                    if(l == best_ask_before_){
+                        best_ask_resized_ = static_cast<size_t>(target_);
+                    }
+                }
 
+                limits_.swap(limits_resized_);
+                occupied_ = std::move(occupied_resized_);
+                codec_ = codec_resized_;
                 valid_limits = new_limits;
+
+                best_bid_ = &limits_.front();
+                if(has_bid_before_){
+                    if(computation::hierarchical_bitmap::npos != best_bid_resized_){
+                        best_bid_ = &limits_[best_bid_resized_];
+                    }else if(best_bid_above_){
+                        // the best bids were cut off, but all asks are above
+                        // them, so the highest remaining level is a bid
+                        seek_best_bid_(static_cast<limit>(limits_.size()) - 1);
+                    }
+                }
+
+                best_ask_ = &limits_.back();
+                if(has_ask_before_){
+                    if(computation::hierarchical_bitmap::npos != best_ask_resized_){
+                        best_ask_ = &limits_[best_ask_resized_];
+                    }else if(!best_ask_above_){
+                        // the best asks were cut off below the interval, and
+                        // the lowest remaining level is an ask
+                        seek_best_ask_(0);
+                    }
+                }
             }
 
+        private:
+            ///
+            /// \brief  Moves the valid interval so that it contains the quote
+            ///         and all resting orders, keeping its width unless they do
+            ///         not fit.
+            ///
+            /// \return false if the recentring policy does not allow the
+            ///         interval to contain the quote
+            bool recentre_(const quote &q)
+            {
+                quote lowest_ = q;
+                quote highest_ = q;
+                auto first_ = occupied_.next(0);
+                if(computation::hierarchical_bitmap::npos != first_){
+                    lowest_  = std::min(lowest_, codec_.decode(static_cast<limit>(first_)));
+                    highest_ = std::max(highest_, codec_.decode(static_cast<limit>(occupied_.previous(limits_.size() - 1))));
+                }
+
+                const quote range_ = highest_ - lowest_;
+                quote width_ = valid_limits.upper - valid_limits.lower;
+                if(width_ < range_){
+                    width_ = range_ * recentring.growth;
+                }
+
+                // the new limits are computed in price units, and are kept on
+                // the grid of the current limits so that resting orders keep
+                // their own level
+                const auto &anchor_ = std::get<price>(valid_limits.lower.type);
+                std::int64_t step_ = 1;
+                if(1 < codec_.levels()){
+                    step_ = std::max<std::int64_t>(1
+                        , std::get<price>(codec_.decode(1).type).value - std::get<price>(codec_.decode(0).type).value);
+                }
+                const auto floor_ = [step_](std::int64_t v){
+                    return (v >= 0 ? v : v - step_ + 1) / step_ * step_;
+                };
+
+                const auto lowest_value_  = std::get<price>(lowest_.type).value;
+                const auto highest_value_ = std::get<price>(highest_.type).value;
+                const auto width_value_   = std::get<price>(width_.type).value;
+                const auto range_value_   = highest_value_ - lowest_value_;
+
+                // centre the resting orders, round down onto the grid, and
+                // never go below zero
+                auto lower_ = lowest_value_ - (width_value_ - range_value_) / 2;
+                lower_ = anchor_.value + floor_(lower_ - anchor_.value);
+                if(lower_ < 0){
+                    lower_ = anchor_.value - floor_(anchor_.value);
+                }
+                // rounding down may leave the highest order outside
+                auto upper_ = std::max(lower_ + width_value_, highest_value_);
+                upper_ = lower_ - floor_(lower_ - upper_);
+
+                mathematics::interval<quote> recentred_
+                    ( quote(price(lower_, anchor_.valuation), valid_limits.lower.lot)
+                    , quote(price(upper_, anchor_.valuation), valid_limits.lower.lot));
+
+                if(0 < recentring.maximum_levels
+                   && recentring.maximum_levels < price_codec_t_(recentred_).levels()){
+                    return false;
+                }
+
+                resize(recentred_);
+                return true;
+            }
+
+        public:
             /// 
             /// \brief lists all open orders
             /// 
@@ -282,12 +533,11 @@ namespace esl::economics::markets::order_book {
                 std::vector<basic_book::order_identifier> result_;
 
 
-                for(auto i = &limits_[0]; i <= &limits_[limits_.size() - 1]; ++i) {
-                    for(auto o = i->first; o; o = o->data.successor) {
+                for( auto l = occupied_.next(0)
+                   ; computation::hierarchical_bitmap::npos != l
+                   ; l = occupied_.next(l + 1)) {
+                    for(const auto *o = limits_[l].first; o; o = block_(o->data.successor)) {
                         result_.push_back(o->index);
-                        if(o->data.successor == o) {
-                            break;
-                        }
                     }
                 }
 
@@ -302,11 +552,11 @@ namespace esl::economics::markets::order_book {
             /// \return
             [[nodiscard]] std::optional<quote> bid() const override
             {
-                if(!best_bid_->first){
+                if(!has_bid_()){
                     return {};
                 }
                 std::ptrdiff_t limit_ = best_bid_ - &limits_[0];
-                return decode(valid_limits, limit_);
+                return codec_.decode(limit_);
             }
 
             ///
@@ -315,12 +565,35 @@ namespace esl::economics::markets::order_book {
             /// \return
             [[nodiscard]] std::optional<quote> ask() const override
             {
-                if(!best_ask_->first){
+                if(!has_ask_()){
                     return {};
                 }
 
                 std::ptrdiff_t limit_ = best_ask_ - &limits_[0];
-                return decode(valid_limits, limit_);
+                return codec_.decode(limit_);
+            }
+
+            ///
+            /// \brief  The best `levels` price levels on one side, read from
+            ///         the per-level aggregates.
+            ///
+            [[nodiscard]] std::vector<depth_level> depth(limit_order::side_t side, std::size_t levels) const override
+            {
+                std::vector<depth_level> result_;
+                if(limit_order::buy == side && has_bid_()){
+                    for( auto l = static_cast<size_t>(best_bid_ - &limits_[0])
+                       ; computation::hierarchical_bitmap::npos != l && result_.size() < levels
+                       ; l = (0 == l ? computation::hierarchical_bitmap::npos : occupied_.previous(l - 1))) {
+                        result_.push_back({codec_.decode(static_cast<limit>(l)), limits_[l].quantity, limits_[l].orders});
+                    }
+                }else if(limit_order::sell == side && has_ask_()){
+                    for( auto l = static_cast<size_t>(best_ask_ - &limits_[0])
+                       ; computation::hierarchical_bitmap::npos != l && result_.size() < levels
+                       ; l = occupied_.next(l + 1)) {
+                        result_.push_back({codec_.decode(static_cast<limit>(l)), limits_[l].quantity, limits_[l].orders});
+                    }
+                }
+                return result_;
             }
 
             ///
@@ -335,7 +608,7 @@ namespace esl::economics::markets::order_book {
                                           , std::uint32_t &remainder_
                                           , limit_type *level)
             {
-                for(auto ao = level->first; 0 < remainder_; ao = ao->data.successor){
+                for(auto ao = level->first; 0 < remainder_; ao = block_(ao->data.successor)){
                     uint32_t execution_size_ = 0;
 
                     const bool exhausted_ = ao->data.quantity <= remainder_;
@@ -349,39 +622,39 @@ namespace esl::economics::markets::order_book {
                         execution_size_ = ao->data.quantity;
                         remainder_ -= execution_size_;
                         ao->data.quantity = 0;
+                        --level->orders;
 
                         // this exhausted the highest-priority order, so we should now erase it
-                        if(ao->data.successor) {
+                        level->first = block_(ao->data.successor);
+                        if(level->first) {
                             // the preceding order was exhausted
-                            ao->data.successor->data.predecessor = nullptr;
+                            level->first->data.predecessor = record::no_link;
                         }
-                        // whether there is one or not, move the pointer in the index 
-                        level->first = ao->data.successor;
 
                     }
 
-                    auto quote_ = decode(valid_limits, level - &limits_[0]);
+                    level->quantity -= execution_size_;
+
+                    auto quote_ = codec_.decode(level - &limits_[0]);
                     // execution report for liquidity taker
-                    reports.emplace_back(execution_report
-                                             ( execution_report::match
-                                             , order.side
-                                             , execution_size_
-                                             , basic_book::direct_order
-                                             , quote_
-                                             , order.owner
-                                             ));
+                    report( execution_report::match
+                          , order.side
+                          , execution_size_
+                          , basic_book::direct_order
+                          , quote_
+                          , order.owner
+                          );
 
                     // execution report for supplier
-                    reports.emplace_back(execution_report
-                                             ( execution_report::match
-                                             , (order.side == limit_order::sell ? limit_order::buy : limit_order::sell)
-                                             ,  execution_size_
-                                             , ao->index
-                                             , quote_
-                                             , ao->data.owner
-                                             ));
-
-                    auto successor_ = ao->data.successor;
+                    report( execution_report::match
+                          , (order.side == limit_order::sell ? limit_order::buy : limit_order::sell)
+                          ,  execution_size_
+                          , ao->index
+                          , quote_
+                          , owners_[ao->data.owner]
+                          );
+
+                    auto successor_ = block_(ao->data.successor);
                     
                     if(exhausted_) {
                         //std::cout << "\t\t exhausted order " << ao->index << std::endl;
@@ -402,24 +675,16 @@ namespace esl::economics::markets::order_book {
                         level->first = nullptr;
                         level->second = nullptr;
 
+                        const limit emptied_ = level - &limits_[0];
+                        occupied_.reset(static_cast<size_t>(emptied_));
+
                         // if the aggressor was a buy order, it took away
-                        // the best ask
+                        // the best ask, so we find the next order above it,
+                        // otherwise it took away the best bid
                         if(order.side == limit_order::buy){
-                            // increase the best ask, until we find an order, or exhaust the order book
-                            // TODO: worst_ask_
-                            for(++best_ask_; best_ask_ <= &limits_.back(); ++best_ask_){
-                                if(best_ask_->first || best_ask_ == &limits_.back()){
-                                    break;
-                                }
-                            }
+                            seek_best_ask_(emptied_ + 1);
                         }else{
-                            // decrease the best bid, until we find an order, or exhaust the order book
-                            // TODO: worst_bid_
-                            for(--best_bid_; best_bid_ >= &limits_[0]; --best_bid_){
-                                if(best_bid_->first || best_bid_ == &limits_[0]){
-                                    break;
-                                }
-                            }
+                            seek_best_bid_(emptied_ - 1);
                         }
                     }
                     break;
@@ -435,6 +700,12 @@ namespace esl::economics::markets::order_book {
             /// \return
             void insert(const limit_order &order) override
             {
+                if(recentring.enabled && 0 < order.quantity
+                   && order.limit.lot == valid_limits.lower.lot
+                   && !valid_limits.contains(order.limit)){
+                    recentre_(order.limit);
+                }
+
                 if(!valid_limits.contains(order.limit) || 0 >= order.quantity || order.limit.lot != valid_limits.lower.lot ){
 
                     if(!valid_limits.contains(order.limit)){
@@ -455,20 +726,19 @@ namespace esl::economics::markets::order_book {
                             << " !=  " << valid_limits.lower.lot << std::endl;
                     }
 
-                    reports.emplace_back(execution_report
-                                             ( execution_report::invalid
-                                             , order.side
-                                             , order.quantity
-                                             , basic_book::direct_order
-                                             , order.limit
-                                             , order.owner
-                                             ));
+                    report( execution_report::invalid
+                          , order.side
+                          , order.quantity
+                          , basic_book::direct_order
+                          , order.limit
+                          , order.owner
+                          );
                     return;
                 }
 
                 std::uint32_t remainder_ = order.quantity;
                 limit limit_index_;
-                auto encode_success_ = encode(valid_limits, order.limit, limit_index_);
+                auto encode_success_ = codec_.encode(order.limit, limit_index_);
 
                 if(!encode_success_){
                     throw esl::exception("quote not mapped to valid order book index");
@@ -482,34 +752,28 @@ namespace esl::economics::markets::order_book {
 
                 limit_type *limit_level_ = &limits_[limit_index_];
 
-                if(order.side == limit_order::buy && ask().has_value() && order.limit >= ask().value()) {
-                    // direct execution: buyer aggressor
-                    for(auto al = best_ask_; al <= limit_level_ && 0 < remainder_; ++al){
-                        if(!al->first){
-                            continue;
-                        }
-                        remainder_ = match_at_level(order, remainder_, al);
+                if(order.side == limit_order::buy && has_ask_() && limit_level_ >= best_ask_) {
+                    // direct execution: buyer aggressor. Emptied levels move
+                    // the best ask to the next non-empty level
+                    while(0 < remainder_ && best_ask_->first && best_ask_ <= limit_level_){
+                        remainder_ = match_at_level(order, remainder_, best_ask_);
                     }
-                }else if(order.side == limit_order::sell && bid().has_value() && order.limit <= bid().value()) {
+                }else if(order.side == limit_order::sell && has_bid_() && limit_level_ <= best_bid_) {
                     // direct execution: seller aggressor
-                    for(auto bl = best_bid_; bl >= limit_level_ && 0 < remainder_; --bl){
-                        if(!bl->first){
-                            continue;
-                        }
-                        remainder_ = match_at_level(order, remainder_, bl);
+                    while(0 < remainder_ && best_bid_->first && best_bid_ >= limit_level_){
+                        remainder_ = match_at_level(order, remainder_, best_bid_);
                     }
 
                 }else if(order.lifetime == limit_order::lifetime_t::immediate_or_cancel
                            || order.lifetime == limit_order::lifetime_t::fill_or_kill){
                     // cancel an immediate/fill order that could not be matched
-                    reports.emplace_back(execution_report
-                                             ( execution_report::cancel
-                                             , order.side
-                                             , order.quantity
-                                             , basic_book::direct_order
-                                             , order.limit
-                                             , order.owner
-                                                 ));
+                    report( execution_report::cancel
+                          , order.side
+                          , order.quantity
+                          , basic_book::direct_order
+                          , order.limit
+                          , order.owner
+                          );
                     return;
                 }
 
@@ -520,58 +784,51 @@ namespace esl::economics::markets::order_book {
                 }
                 if(order.lifetime
                    == limit_order::lifetime_t::immediate_or_cancel) {
-                    reports.emplace_back(execution_report
-                                             ( execution_report::cancel
-                                             , order.side
-                                             , remainder_
-                                             , basic_book::direct_order
-                                             , order.limit
-                                             , order.owner
-                                             ));
+                    report( execution_report::cancel
+                          , order.side
+                          , remainder_
+                          , basic_book::direct_order
+                          , order.limit
+                          , order.owner
+                          );
                     return;
                 }
 
-                auto block_ = pool_.emplace(record
-                                                { order.limit
-                                                , remainder_
-                                                , order.owner
-                                                , nullptr
-                                                , nullptr
-                                                });
+                record record_;
+                record_.level = limit_index_;
+                record_.quantity = remainder_;
+                record_.owner = owners_.intern(order.owner);
+                record_.side = order.side;
+                auto placed_ = pool_.emplace(record_);
                 
-                // we store the identifier in the record
-                if(block_.second) {
-                    block_.second->index = block_.first;
-                }
-                
-                reports.emplace_back(execution_report
-                                         ( execution_report::placement
-                                         , order.side
-                                         , remainder_
-                                         , block_.first
-                                         , order.limit
-                                         , order.owner
-                                         ));
+                report( execution_report::placement
+                      , order.side
+                      , remainder_
+                      , placed_.first
+                      , order.limit
+                      , order.owner
+                      );
 
                 // if this is the first order at this level, then the first of the pair of pointers is null
                 if(!limit_level_->first){
                     // point the main index to the order
-                    limit_level_->first = block_.second;
+                    limit_level_->first = placed_.second;
                     // point the rear of the main index to this order
-                    limit_level_->second = block_.second;
+                    limit_level_->second = placed_.second;
+                    occupied_.set(static_cast<size_t>(limit_index_));
                 }else{
                     // we assert that because there is at least one order, the second pointer of the pair
                     // is set too to the least priority order at this level
                     assert(limit_level_->second != nullptr);
                     // the previously least priority order now is the second to last. Thus, that order's successor is the new order:
-                    assert(limit_level_->second->data.successor !=
-                               block_.second);
-                    limit_level_->second->data.successor = block_.second;
+                    limit_level_->second->data.successor = link_(placed_.second);
                     // and the new order's predecessor is the previous least priority order:
-                    block_.second->data.predecessor = limit_level_->second;
+                    placed_.second->data.predecessor = link_(limit_level_->second);
                     // point the rear of the level pointers to the new order
-                    limit_level_->second = block_.second;
+                    limit_level_->second = placed_.second;
                 }
+                limit_level_->quantity += remainder_;
+                ++limit_level_->orders;
 
                 // because we are inserting, the best bid and ask can strictly improve
                 if(limit_order::buy == order.side){
@@ -586,90 +843,85 @@ namespace esl::economics::markets::order_book {
             /// \brief  Cancels an order by the order identifier returned from
             ///         the order book.
             ///
+            /// \details    The record stores its side and level, so the order
+            ///             is unlinked from its queue in constant time. Orders
+            ///             that were matched or cancelled before are ignored.
+            ///
             /// \param order
             void cancel(basic_book::order_identifier order) override
             {
-                record &order_ = pool_[order];
-
-                auto side_ = limit_order::side_t::buy;
-                // if there is no bid, or the best bid is lower than this order,
-                // this must be a sell order.
-                auto bid_ = bid();
-                if(!bid_.has_value() || bid_.value() < order_.limit){
-                    side_ = limit_order::side_t::sell;
-                }
-
-                limit limit_index_;
-                auto encode_success_ = encode(valid_limits, order_.limit, limit_index_);
-                limit_type *limit_level_ = &limits_[limit_index_];
-
-                
-                // The order could be cancelled/matched before, and nothing is left at this level
-                if(!limit_level_->first || !limit_level_->second) {
+                auto *cancelled_ = pool_.find(order);
+                if(!cancelled_) {
+                    // the order was matched fully/cancelled before, so we can't
+                    // do anything here
                     return;
                 }
 
+                record &order_ = cancelled_->data;
+                limit_type &level_ = limits_[order_.level];
 
-                if(limit_level_->first->index == order) {
-                    limits_[limit_index_].first =
-                        limit_level_->first->data.successor;
+                if(record::no_link != order_.predecessor) {
+                    block_(order_.predecessor)->data.successor = order_.successor;
+                }else{
+                    assert(level_.first == cancelled_);
+                    level_.first = block_(order_.successor);
                 }
 
-
-                if(limit_level_->second->index == order) {
-                    limits_[limit_index_].second =
-                        limit_level_->second->data.predecessor;
+                if(record::no_link != order_.successor) {
+                    block_(order_.successor)->data.predecessor = order_.predecessor;
+                }else{
+                    assert(level_.second == cancelled_);
+                    level_.second = block_(order_.predecessor);
                 }
 
-                // either both were set to an order
-                bool both_set_ = (limits_[limit_index_].first
-                                  && limits_[limit_index_].second);
-                // or both are empty
-                bool none_set_ = (!limits_[limit_index_].first
-                                  && !limits_[limit_index_].second);
-
-                assert(both_set_ || none_set_ );
-
-                auto result_ = pool_.erase(order);
-
-                // canceled
-                if(0 == result_) {
-                    // the order was matched fully/cancelled before, so we can't
-                    // do anything here
-                    //LOG(warning) << "canceled dead order << " << order << std::endl;
-                    return;
+                level_.quantity -= order_.quantity;
+                --level_.orders;
+
+                report( execution_report::cancel
+                      , order_.side
+                      , order_.quantity
+                      , order
+                      , codec_.decode(order_.level)
+                      , owners_[order_.owner]
+                      );
+
+                if(!level_.first) {
+                    occupied_.reset(static_cast<size_t>(order_.level));
+                    // the best level on the order's side was emptied
+                    if(limit_order::buy == order_.side && &level_ == best_bid_) {
+                        seek_best_bid_(order_.level - 1);
+                    }else if(limit_order::sell == order_.side && &level_ == best_ask_) {
+                        seek_best_ask_(order_.level + 1);
+                    }
                 }
-/*
-                std::cout << "cancelling an order of " << order_.quantity
-                          << " times " << order_.limit << std::endl; */ 
-                reports.emplace_back(execution_report
-                                         ( execution_report::cancel
-                                         , side_
-                                         , order_.quantity
-                                         , order
-                                         , order_.limit
-                                         , order_.owner
-                                         ));
 
-                if(order_.predecessor) {
-                    order_.predecessor->data.successor = order_.successor; 
-                }
+                pool_.erase(order);
+            }
 
-                if(order_.successor) {
-                    order_.successor->data.predecessor = order_.predecessor;
-                }
+            using basic_book::insert;
+            using basic_book::cancel;
 
-                if(order_.predecessor) {
-                    order_.predecessor = nullptr;
+            ///
+            /// \brief  Inserts a sequence of orders in order of arrival,
+            ///         without a virtual call per order.
+            ///
+            void insert(const limit_order *first, const limit_order *last) override
+            {
+                reserve_reports(static_cast<std::size_t>(last - first));
+                for(; first != last; ++first){
+                    basic_static_order_book::insert(*first);
                 }
+            }
 
-                if(order_.successor) {
-                    order_.successor = nullptr;
+            ///
+            /// \brief  Cancels a sequence of orders in order.
+            ///
+            void cancel(const basic_book::order_identifier *first, const basic_book::order_identifier *last) override
+            {
+                reserve_reports(static_cast<std::size_t>(last - first));
+                for(; first != last; ++first){
+                    basic_static_order_book::cancel(*first);
                 }
-
-                order_.limit    = quote();
-                order_.owner    = identity<agent>();
-                order_.quantity = 0;
             }
 
             ///
@@ -685,19 +937,16 @@ namespace esl::economics::markets::order_book {
 
                 std::uint64_t displayed_ = 0;
                 std::vector<std::pair<std::uint32_t, double>> ask_displayed_;
-                for(auto i = best_ask_; i <= &limits_[limits_.size() - 1] && displayed_ < levels; ++i) {
-                    if(!i->first) {
-                        continue;
-                    }
-                    std::uint64_t quantity_ = 0;
-                    for(auto *j = i->first; nullptr != j; j = j->data.successor) {
-                        quantity_ += j->data.quantity;
-                    }
+                for( auto l = occupied_.next(static_cast<size_t>(best_ask_ - &limits_[0]))
+                   ; computation::hierarchical_bitmap::npos != l && displayed_ < levels
+                   ; l = occupied_.next(l + 1)) {
+                    const limit_type *i = &limits_[l];
+                    std::uint64_t quantity_ = i->quantity;
                     if(quantity_ <= 0) {
                         continue;
                     }
 
-                    ask_displayed_.emplace_back(quantity_,double(decode(valid_limits, i - &limits_[0]))* valid_limits.lower.lot);
+                    ask_displayed_.emplace_back(quantity_,double(codec_.decode(l))* valid_limits.lower.lot);
 
                     ++displayed_;
                 }
@@ -715,14 +964,11 @@ namespace esl::economics::markets::order_book {
                 //std::cout << "------------------------------------------------" << std::endl;
 
                 displayed_ = 0;
-                for(auto i = best_bid_; i >= &limits_[0] && displayed_ < levels; --i) {
-                    if(!i->first) {
-                        continue;
-                    }
-                    std::uint64_t quantity_ = 0;
-                    for(auto *j = i->first; nullptr != j; j = j->data.successor) {
-                        quantity_ += j->data.quantity;
-                    }
+                for( auto l = occupied_.previous(static_cast<size_t>(best_bid_ - &limits_[0]))
+                   ; computation::hierarchical_bitmap::npos != l && displayed_ < levels
+                   ; l = (0 == l ? computation::hierarchical_bitmap::npos : occupied_.previous(l - 1))) {
+                    const limit_type *i = &limits_[l];
+                    std::uint64_t quantity_ = i->quantity;
                     if(quantity_ <= 0) {
                         continue;
                     }
@@ -730,8 +976,8 @@ namespace esl::economics::markets::order_book {
                               << quantity_ << " | "
                               << std::left << std::setw(14)
                         << std::setprecision(int(std::log10(valid_limits.lower.lot)))
-                        << double(decode(valid_limits, i - &limits_[0])) * valid_limits.lower.lot
-                        //<< double(decode(valid_limits, i - &limits_[0])) * valid_limits.lower.lot
+                        << double(codec_.decode(l)) * valid_limits.lower.lot
+                        //<< double(codec_.decode(l)) * valid_limits.lower.lot
                               << " | "
                               << std::endl;
                     ++displayed_;
@@ -740,6 +986,11 @@ namespace esl::economics::markets::order_book {
             }
 
         };
+
+        ///
+        /// \brief  The static order book using the default price codec
+        ///
+        typedef basic_static_order_book<> static_order_book;
 }//namespace
 
 #endif  // ESL_STATIC_ORDER_BOOK_HPP
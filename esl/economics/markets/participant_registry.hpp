@@ -0,0 +1,120 @@
+/// \file   participant_registry.hpp
+///
+/// \brief  Assigns dense indices to the participants of a market.
+///
+/// \authors    Maarten P. Scholl
+/// \date       2026-10-17
+/// \copyright  Copyright 2017-2026 The Institute for New Economic Thinking,
+///             Oxford Martin School, University of Oxford
+///
+///             Licensed under the Apache License, Version 2.0 (the "License");
+///             you may not use this file except in compliance with the License.
+///             You may obtain a copy of the License at
+///
+///                 http://www.apache.org/licenses/LICENSE-2.0
+///
+///             Unless required by applicable law or agreed to in writing,
+///             software distributed under the License is distributed on an "AS
+///             IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+///             express or implied. See the License for the specific language
+///             governing permissions and limitations under the License.
+///
+///             You may obtain instructions to fulfill the attribution
+///             requirements in CITATION.cff
+///
+#ifndef ESL_PARTICIPANT_REGISTRY_HPP
+#define ESL_PARTICIPANT_REGISTRY_HPP
+
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include <esl/agent.hpp>
+#include <esl/simulation/identity.hpp>
+
+
+namespace esl::economics::markets {
+
+    ///
+    /// \brief  Interns participant identities, so that per-participant
+    ///         state can be kept in arrays indexed by slot.
+    ///
+    /// \details    Slots are assigned in order of first appearance and are
+    ///             never reused, so that a slot identifies the same
+    ///             participant for the lifetime of the market. Identities are
+    ///             only hashed when they enter the market; after that,
+    ///             participants are referred to by slot.
+    ///
+    class participant_registry
+    {
+    public:
+        typedef std::uint32_t slot_t;
+
+    private:
+        std::unordered_map<identity<agent>, slot_t> slots_;
+
+        std::vector<identity<agent>> identities_;
+
+        ///
+        /// \brief  Whether the participant is logged on, by slot
+        ///
+        std::vector<bool> active_;
+
+    public:
+        ///
+        /// \return the slot of the participant, assigning one if needed
+        ///
+        slot_t intern(const identity<agent> &participant)
+        {
+            auto [i, inserted_] = slots_.try_emplace(participant, static_cast<slot_t>(identities_.size()));
+            if(inserted_){
+                identities_.push_back(participant);
+                active_.push_back(false);
+            }
+            return i->second;
+        }
+
+        [[nodiscard]] std::optional<slot_t> find(const identity<agent> &participant) const
+        {
+            auto i = slots_.find(participant);
+            if(slots_.end() == i){
+                return {};
+            }
+            return i->second;
+        }
+
+        [[nodiscard]] const identity<agent> &operator [] (slot_t slot) const
+        {
+            return identities_[slot];
+        }
+
+        ///
+        /// \brief  Number of slots assigned
+        ///
+        [[nodiscard]] std::size_t size() const
+        {
+            return identities_.size();
+        }
+
+        [[nodiscard]] bool active(slot_t slot) const
+        {
+            return slot < active_.size() && active_[slot];
+        }
+
+        void activate(slot_t slot, bool active = true)
+        {
+            active_[slot] = active;
+        }
+
+        void reserve(std::size_t participants)
+        {
+            slots_.reserve(participants);
+            identities_.reserve(participants);
+            active_.reserve(participants);
+        }
+    };
+
+}  // namespace esl::economics::markets
+
+#endif  // ESL_PARTICIPANT_REGISTRY_HPP
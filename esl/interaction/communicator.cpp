@@ -25,8 +25,11 @@
 #include <esl/interaction/communicator.hpp>
 #include <esl/data/log.hpp>
 
+#include <algorithm>
+#include <array>
 #include <chrono>
 using std::chrono::high_resolution_clock;
+#include <limits>
 
 namespace esl::interaction {
     communicator::communicator(scheduling schedule)
@@ -80,6 +83,12 @@ namespace esl::interaction {
 
 
 
+    ///
+    /// \details   Messages are handled in order of the highest priority of
+    ///             their callbacks. They are bucketed by that priority with a
+    ///             counting sort, so that only the messages delivered by now
+    ///             are visited and no memory is allocated once `dispatch_`
+    ///             has grown to the largest number of messages per round.
     ///
     /// \param step
     /// \param seed
@@ -88,54 +97,66 @@ namespace esl::interaction {
     communicator::process_messages(const simulation::time_interval &step,
                                    std::seed_seq &seed)
     {
-        // create mapping priority -> message
-        std::multimap< priority_t
-                     , message_t
-                     , std::less<>
-                     , boost::fast_pool_allocator<std::pair<const priority_t, message_t>>
-                     > priority_;
+        constexpr std::size_t priorities_ = std::size_t(1) << (8 * sizeof(priority_t));
+
+        // bucket 0 holds the highest priority
+        auto bucket_ = [this](const message_t &m) -> std::size_t {
+            auto callback_ = callbacks_.find(m->type);
+            if(callbacks_.end() == callback_ || callback_->second.empty()) {
+                return priorities_;  // no callbacks that process this message
+            }
+            return std::size_t(std::numeric_limits<priority_t>::max() - callback_->second.rbegin()->first);
+        };
+
+        // bounds_[b + 1] is the number of messages in buckets up to b
+        std::array<std::size_t, priorities_ + 1> bounds_ = {};
         for(const auto &[k, m]: inbox) {
             // message will be received in the future
             if(k > step.lower) {
                 break;
             }
-
-            auto callback_ = callbacks_.find(m->type);
-            if(callbacks_.end() == callback_ || callback_->second.empty()) {
-                continue;  // no callbacks that process this message
+            auto b = bucket_(m);
+            if(b < priorities_) {
+                ++bounds_[b + 1];
             }
+        }
+        for(std::size_t b = 1; b <= priorities_; ++b) {
+            bounds_[b] += bounds_[b - 1];
+        }
 
-            auto highest_priority = std::numeric_limits<priority_t>::min();
-            for(const auto &[p, cf] : callback_->second) {
-                (void) cf;
-                highest_priority = std::max(highest_priority, p);
+        // messages with the same priority are placed from the back, which
+        // handles them in reverse order of delivery
+        dispatch_.resize(bounds_[priorities_]);
+        auto cursors_ = bounds_;
+        for(const auto &[k, m]: inbox) {
+            if(k > step.lower) {
+                break;
+            }
+            auto b = bucket_(m);
+            if(b < priorities_) {
+                dispatch_[--cursors_[b + 1]] = m;
             }
-
-            priority_.insert(std::make_pair(highest_priority, m));
         }
 
         auto first_event_ = step.upper;
-
-        for(auto i = priority_.rbegin(); i != priority_.rend(); ++i) {
-            std::vector<message_t> equal_;
-            for(auto upper_ = i;
-                upper_ != priority_.rend() && upper_->first == i->first;
-                ++upper_) {
-                equal_.push_back(upper_->second);
-                i = upper_;
+        for(std::size_t b = 0; b < priorities_; ++b) {
+            auto first_ = dispatch_.begin() + std::ptrdiff_t(bounds_[b]);
+            auto last_ = dispatch_.begin() + std::ptrdiff_t(bounds_[b + 1]);
+            if(first_ == last_) {
+                continue;
             }
 
             if(random == schedule) {
                 std::minstd_rand g(seed);
-                std::shuffle(equal_.begin(), equal_.end(), g);
+                std::shuffle(first_, last_, g);
             }
 
-            for(const auto &m : equal_) {
-                auto next_event_ = process_message(m, step, seed);
+            for(auto i = first_; i != last_; ++i) {
+                auto next_event_ = process_message(*i, step, seed);
                 first_event_     = std::min(first_event_, next_event_);
-
             }
         }
+        dispatch_.clear();
         return first_event_;
     }
 
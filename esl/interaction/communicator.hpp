@@ -39,6 +39,7 @@
 
 #include <esl/computation/allocator.hpp>
 #include <esl/interaction/header.hpp>
+#include <esl/interaction/message_queue.hpp>
 
 
 namespace esl::simulation {
@@ -101,12 +102,7 @@ namespace esl::interaction {
         ///
         /// \brief  The inbox stores messages by delivery time.
         ///
-        typedef boost::container::flat_multimap< simulation::time_point
-                             , message_t
-                             , std::less<>
-                             //, boost::fast_pool_allocator<std::pair<const simulation::time_point, message_t> >
-                             //, computation::allocator<std::pair<const simulation::time_point, message_t> >
-                             > inbox_t;
+        typedef message_queue inbox_t;
 
         ///
         typedef std::vector<message_t, boost::pool_allocator<message_t>> outbox_t;
@@ -141,6 +137,12 @@ namespace esl::interaction {
         boost::container::flat_map<message_code, boost::container::flat_multimap<priority_t, callback_t>>
             callbacks_;
 
+        ///
+        /// \brief  The messages handled by `process_messages`, ordered by
+        ///         priority. Kept between calls to reuse the storage.
+        ///
+        std::vector<message_t> dispatch_;
+
 
         ///
         /// \brief  when true, modifying the callbacks data structure results
@@ -0,0 +1,227 @@
+/// \file   message_queue.hpp
+///
+/// \brief  Messages ordered by delivery time, from which delivered messages
+///         are consumed without rebuilding the queue.
+///
+/// \authors    Maarten P. Scholl
+/// \date       2026-10-17
+/// \copyright  Copyright 2017-2026 The Institute for New Economic Thinking,
+///             Oxford Martin School, University of Oxford
+///
+///             Licensed under the Apache License, Version 2.0 (the "License");
+///             you may not use this file except in compliance with the License.
+///             You may obtain a copy of the License at
+///
+///                 http://www.apache.org/licenses/LICENSE-2.0
+///
+///             Unless required by applicable law or agreed to in writing,
+///             software distributed under the License is distributed on an "AS
+///             IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+///             express or implied. See the License for the specific language
+///             governing permissions and limitations under the License.
+///
+///             You may obtain instructions to fulfill the attribution
+///             requirements in CITATION.cff
+///
+#ifndef ESL_INTERACTION_MESSAGE_QUEUE_HPP
+#define ESL_INTERACTION_MESSAGE_QUEUE_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <boost/serialization/nvp.hpp>
+#include <boost/serialization/shared_ptr.hpp>
+#include <boost/serialization/utility.hpp>
+#include <boost/serialization/vector.hpp>
+
+#include <esl/interaction/header.hpp>
+#include <esl/simulation/time.hpp>
+
+
+namespace esl::interaction {
+
+    ///
+    /// \brief  A sorted sequence of (delivery time, message), with the
+    ///         interface of a multimap.
+    ///
+    /// \details    Messages with the same delivery time are kept in order of
+    ///             insertion. `consume` moves a cursor past the messages that
+    ///             have been handled, so that discarding them costs nothing
+    ///             per remaining message; the storage is compacted only once
+    ///             the consumed prefix is at least half of it, and its
+    ///             capacity is kept for later messages.
+    ///
+    class message_queue
+    {
+    public:
+        typedef simulation::time_point key_type;
+
+        typedef std::shared_ptr<header> mapped_type;
+
+        typedef std::pair<key_type, mapped_type> value_type;
+
+        typedef std::vector<value_type>::iterator iterator;
+
+        typedef std::vector<value_type>::const_iterator const_iterator;
+
+        typedef std::size_t size_type;
+
+        typedef std::ptrdiff_t difference_type;
+
+    private:
+        std::vector<value_type> entries_;
+
+        ///
+        /// \brief  Number of entries at the front that were consumed
+        ///
+        size_type consumed_ = 0;
+
+        ///
+        /// \brief  Consumed prefixes shorter than this are not compacted
+        ///
+        constexpr static size_type compact_ = 32;
+
+        static bool before_(const value_type &e, key_type k)
+        {
+            return e.first < k;
+        }
+
+        static bool after_(key_type k, const value_type &e)
+        {
+            return k < e.first;
+        }
+
+    public:
+        [[nodiscard]] iterator begin()
+        {
+            return entries_.begin() + difference_type(consumed_);
+        }
+
+        [[nodiscard]] iterator end()
+        {
+            return entries_.end();
+        }
+
+        [[nodiscard]] const_iterator begin() const
+        {
+            return entries_.begin() + difference_type(consumed_);
+        }
+
+        [[nodiscard]] const_iterator end() const
+        {
+            return entries_.end();
+        }
+
+        [[nodiscard]] size_type size() const
+        {
+            return entries_.size() - consumed_;
+        }
+
+        [[nodiscard]] bool empty() const
+        {
+            return entries_.size() == consumed_;
+        }
+
+        [[nodiscard]] std::less<key_type> key_comp() const
+        {
+            return {};
+        }
+
+        ///
+        /// \brief  Inserts after the messages with the same delivery time.
+        ///         Messages usually arrive in order of delivery time, in
+        ///         which case they are appended.
+        ///
+        iterator insert(value_type entry)
+        {
+            if(empty()){
+                clear();
+            }
+            if(entries_.empty() || entries_.back().first <= entry.first){
+                entries_.push_back(std::move(entry));
+                return entries_.end() - 1;
+            }
+            auto position_ = std::upper_bound(begin(), end(), entry.first, after_);
+            return entries_.insert(position_, std::move(entry));
+        }
+
+        template<typename... arguments_>
+        iterator emplace(arguments_ &&... arguments)
+        {
+            return insert(value_type(std::forward<arguments_>(arguments)...));
+        }
+
+        ///
+        /// \return the first message delivered at `delivery`, or end()
+        ///
+        [[nodiscard]] iterator find(key_type delivery)
+        {
+            auto i = std::lower_bound(begin(), end(), delivery, before_);
+            return (end() != i && i->first == delivery) ? i : end();
+        }
+
+        [[nodiscard]] const_iterator find(key_type delivery) const
+        {
+            auto i = std::lower_bound(begin(), end(), delivery, before_);
+            return (end() != i && i->first == delivery) ? i : end();
+        }
+
+        ///
+        /// \return the number of messages removed
+        ///
+        size_type erase(key_type delivery)
+        {
+            auto first_ = std::lower_bound(begin(), end(), delivery, before_);
+            auto last_ = std::upper_bound(first_, end(), delivery, after_);
+            auto result_ = size_type(last_ - first_);
+            entries_.erase(first_, last_);
+            return result_;
+        }
+
+        iterator erase(const_iterator position)
+        {
+            return entries_.erase(position);
+        }
+
+        void clear()
+        {
+            entries_.clear();
+            consumed_ = 0;
+        }
+
+        ///
+        /// \brief  Discards all messages delivered at or before `delivery`
+        ///
+        void consume(key_type delivery)
+        {
+            while(consumed_ < entries_.size() && entries_[consumed_].first <= delivery){
+                // release the message, the entry itself is reused
+                entries_[consumed_].second.reset();
+                ++consumed_;
+            }
+            if(empty()){
+                clear();
+            }else if(compact_ <= consumed_ && entries_.size() <= 2 * consumed_){
+                entries_.erase(entries_.begin(), begin());
+                consumed_ = 0;
+            }
+        }
+
+        template<class archive_t>
+        void serialize(archive_t &archive, const unsigned int version)
+        {
+            (void)version;
+            // consumed entries are not archived
+            entries_.erase(entries_.begin(), begin());
+            consumed_ = 0;
+            archive &boost::serialization::make_nvp("entries", entries_);
+        }
+    };
+
+}  // namespace esl::interaction
+
+#endif  // ESL_INTERACTION_MESSAGE_QUEUE_HPP
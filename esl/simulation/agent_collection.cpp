@@ -41,6 +41,7 @@ namespace esl::simulation {
     {
         global_agents_.insert(a->identifier);
         local_agents_.insert({a->identifier, a});
+        changes_.emplace_back(a->identifier, true);
         environment_.get().activate_agent(a->identifier);
     }
 
@@ -48,6 +49,7 @@ namespace esl::simulation {
     {
         global_agents_.erase(a->identifier);
         local_agents_.erase(a->identifier);
+        changes_.emplace_back(a->identifier, false);
         environment_.get().deactivate_agent(a->identifier);
     }
 
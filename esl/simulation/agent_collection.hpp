@@ -28,6 +28,8 @@
 #include <memory>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
+#include <vector>
 
 #include <boost/container/flat_set.hpp>
 #include <boost/container/flat_map.hpp>
@@ -63,6 +65,13 @@ namespace esl::simulation {
 
         boost::container::flat_map<identity<agent>, std::shared_ptr<agent>> local_agents_;
 
+        ///
+        /// \brief  Agents activated (true) or deactivated (false) since the
+        ///         model last scheduled them, in order, so that the model
+        ///         does not have to compare its schedule with all agents.
+        ///
+        std::vector<std::pair<identity<agent>, bool>> changes_;
+
         explicit agent_collection(std::reference_wrapper<computation::environment> environment_);
 
         template<typename agent_derived_t_, typename entity_type_>
@@ -26,12 +26,17 @@
 
 #include <chrono>
 using std::chrono::high_resolution_clock;
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <future>
 #include <numeric>
 
 #include <esl/agent.hpp>
 #include <esl/computation/environment.hpp>
+#include <esl/computation/thread_pool.hpp>
 #include <esl/data/log.hpp>
-#include <esl/quantity.hpp>
+#include <esl/exception.hpp>
 
 
 namespace esl::simulation {
@@ -66,22 +71,10 @@ namespace esl::simulation {
     /// \return The first upcoming event
     time_point model::determine_next_event() const
     {
-        time_point result_ = end;
-        std::vector<identity<agent>> blockers_;
-        //for(auto &[i, a] : agents.local_agents_) {
-        //    auto iterator_ = wake_up_times.find(i);
-        for(const auto &[i, t] : wake_up_times) {
-            if(result_ > t) {
-                blockers_ = {i};  //.clear();
-                result_   = std::min(result_, t);
-            } else if(result_ == t) {
-                blockers_.push_back(i);
-            }
+        if(wake_up_times.empty()){
+            return end;
         }
-        //}
-        // 
-        //LOG(trace) << "blockers at t=" << result_ << ": " << blockers_ << std::endl;
-        return result_;
+        return std::min(end, wake_up_times.top());
     }
 
 
@@ -98,8 +91,21 @@ namespace esl::simulation {
 
         //std::cout << "wake_up_times " << wake_up_times << std::endl;
 
+        // wake-up times are recorded by each thread without locking, and
+        // merged into wake_up_times after the round. Buffers are aligned so
+        // that threads appending to their own buffer do not share a cache
+        // line
+        struct alignas(64) wake_ups_t
+        {
+            std::vector<std::pair<const agent *, time_point>> entries;
+        };
+        std::vector<wake_ups_t> wake_ups_(std::max<std::uint64_t>(1, threads));
+
+        // the agents acting in a round, found from the wake-up times of the
+        // agents that are due rather than by going over all agents
+        std::vector<std::shared_ptr<agent>> acting_agents_;
+
         // read the sample index from the parameter collection
-        std::mutex mutex_first_event_;
         time_point first_event_   = step.upper;
         unsigned int round_ = 0;
         do {
@@ -111,7 +117,7 @@ namespace esl::simulation {
             // in the future
             first_event_   = determine_next_event();
 
-            auto job_ = [&](std::shared_ptr<agent> a){
+            auto job_ = [&](const std::shared_ptr<agent> &a, wake_ups_t &wake_ups){
                 //LOG(trace) << "act " << a->identifier << std::endl;
                 // double agent_cb_end_;
                 // timings_.emplace(i, 0.);
@@ -138,9 +144,6 @@ namespace esl::simulation {
                     // agent_cb_end_ = double((high_resolution_clock::now() - agent_start_).count()); agent_act_ = high_resolution_clock::now();
                     auto act_time_ = a->act(step, seed_);
 
-                    // from this part, we update the global first event, and update the wakeup time
-                    // it is important we don't touch the wake_up_times either without locking
-                    std::unique_lock lock_(mutex_first_event_);
                     auto wake_up_ = std::min(message_time_, act_time_);
                     if(wake_up_ < step.lower){
                         std::stringstream stream_;
@@ -148,12 +151,8 @@ namespace esl::simulation {
                         throw std::logic_error(stream_.str());
                     }
 
-                    //first_event_ = std::min(first_event_, wake_up_);
-
-                    //std::cout << a->identifier << " wakes up next at " << first_event_ << std::endl;
-                    wake_up_times[a->identifier] = wake_up_;
-
-                    first_event_   = determine_next_event();
+                    //std::cout << a->identifier << " wakes up next at " << wake_up_ << std::endl;
+                    wake_ups.entries.emplace_back(a.get(), wake_up_);
                 }
 
                 //} catch(const std::runtime_error &e) {
@@ -166,16 +165,8 @@ namespace esl::simulation {
                 //    throw;
                 //}
 
-                {
-                    esl::interaction::communicator::inbox_t to_be_received_;
-                    for(auto &[time_, message_]: a->inbox){
-                        if(time_ > step.lower){
-                            to_be_received_.insert({time_, message_});
-                        }
-                    }
-
-                    a->inbox = to_be_received_; //.clear();
-                }
+                // messages up to now have been handled
+                a->inbox.consume(step.lower);
 
 
 
@@ -190,57 +181,112 @@ namespace esl::simulation {
             };
 
 
-            std::vector<std::shared_ptr<agent>> acting_agents_;
-            acting_agents_.reserve(agents.local_agents_.size());
-            for(auto &[i, a]: agents.local_agents_) {
-                auto w = wake_up_times.find(i);
-                if(wake_up_times.end() == w){
-                    auto [ww, _] = wake_up_times.emplace(i, step.lower);
-                    w=ww;
+            // agents that were activated since the last round act immediately,
+            // and deactivated agents are no longer scheduled
+            for(const auto &[i, active_]: agents.changes_){
+                if(!active_){
+                    wake_up_times.erase(i);
+                }else if(!wake_up_times.contains(i)){
+                    wake_up_times.set(i, step.lower);
                 }
-                // this comparison is strict equality, because an agent
-                // returning a time_point before the current time form act() is
-                // a logical error
-                if(w->second == step.lower){
-                    //std::cout << "active " << i << a->describe() << std::endl;
-                    acting_agents_.push_back(a);
+            }
+            agents.changes_.clear();
+            // agents can also be added to the collection directly
+            if(wake_up_times.size() < agents.local_agents_.size()){
+                for(auto &[i, a]: agents.local_agents_) {
+                    (void)a;
+                    if(!wake_up_times.contains(i)){
+                        wake_up_times.set(i, step.lower);
+                    }
                 }
             }
 
+            acting_agents_.clear();
+            // this comparison is strict equality, because an agent returning a
+            // time_point before the current time form act() is a logical error
+            std::vector<identity<agent>> inactive_;
+            wake_up_times.due(step.lower, [&](const identity<agent> &i, time_point t){
+                auto a = agents.local_agents_.find(i);
+                if(agents.local_agents_.end() == a){
+                    inactive_.push_back(i);
+                }else if(t == step.lower){
+                    acting_agents_.push_back(a->second);
+                }
+            });
+            for(const auto &i: inactive_){
+                wake_up_times.erase(i);
+            }
+            // the heap visits agents in no particular order, so act in order
+            // of identity as before
+            std::sort(acting_agents_.begin(), acting_agents_.end(), [](const auto &a, const auto &b){
+                return a->identifier < b->identifier;
+            });
+
             //std::cout << "acting_agents_" << acting_agents_ << std::endl;
 
+            for(auto &w: wake_ups_){
+                w.entries.clear();
+            }
             // important: if using a single thread, run everything in main
-            if(threads <= 1) {
+            if(threads <= 1 || acting_agents_.size() <= 1) {
                 for(auto &a: acting_agents_) {
-                    job_(a);
+                    job_(a, wake_ups_[0]);
                 }
             }else{
-                std::vector<std::thread> threads_;
-                auto iterator_ = acting_agents_.begin();
-                for(const auto& tasks_: quantity(acting_agents_.size()) / threads){
-                    std::vector<std::shared_ptr<agent>> task_split_;
-                    for(auto i = quantity(0); i < tasks_; ++i){
-                        task_split_.push_back(*iterator_);
-                        std::advance(iterator_, 1);
+                if(!pool_ || pool_->threads + 1 != threads){
+                    pool_ = std::make_shared<computation::thread_pool>(static_cast<unsigned int>(threads - 1));
+                }
+
+                // guided scheduling: threads claim consecutive agents in
+                // chunks that shrink as the round runs out, so that slow
+                // agents near the end do not hold up the other threads
+                std::atomic<std::size_t> next_ = 0;
+                auto work_ = [&](wake_ups_t &wake_ups){
+                    const auto size_ = acting_agents_.size();
+                    auto first_ = next_.load(std::memory_order_relaxed);
+                    while(first_ < size_){
+                        auto chunk_ = std::max<std::size_t>(1, (size_ - first_) / (2 * threads));
+                        if(!next_.compare_exchange_weak(first_, first_ + chunk_, std::memory_order_relaxed)){
+                            continue;
+                        }
+                        for(auto k = first_; k < first_ + chunk_; ++k){
+                            job_(acting_agents_[k], wake_ups);
+                        }
+                        first_ = next_.load(std::memory_order_relaxed);
                     }
+                };
 
-                    threads_.emplace_back([&](std::vector<std::shared_ptr<agent>> ts)
-                        {
-                            for(const auto& a: ts){
-                                job_(a);
-                            }
-                        }, task_split_);
+                std::vector<std::future<void>> helpers_;
+                auto helper_count_ = std::min<std::size_t>(threads - 1, acting_agents_.size() - 1);
+                for(std::size_t h = 0; h < helper_count_; ++h){
+                    helpers_.push_back(pool_->enqueue_task(work_, std::ref(wake_ups_[h + 1])));
                 }
+                try{
+                    work_(wake_ups_[0]);
+                }catch(...){
+                    for(auto &h: helpers_){
+                        h.wait();
+                    }
+                    throw;
+                }
+                // all helpers finish before any exception is rethrown, as they
+                // refer to this round's state
+                for(auto &h: helpers_){
+                    h.wait();
+                }
+                for(auto &h: helpers_){
+                    h.get();
+                }
+            }
 
-                for(auto &t: threads_){
-                    t.join();
+            for(const auto &w: wake_ups_){
+                for(const auto &[a, t]: w.entries){
+                    wake_up_times.set(a->identifier, t);
                 }
             }
 
             auto messages_sent_ = environment_.send_messages(*this);
-            if(0 < messages_sent_){
-                first_event_   = determine_next_event();
-            }
+            first_event_   = determine_next_event();
 
             messages_sent += messages_sent_;
 
@@ -34,9 +34,12 @@
 #include <esl/simulation/world.hpp>
 #include <esl/simulation/agent_collection.hpp>
 #include <esl/simulation/parameter/parametrization.hpp>
+#include <esl/simulation/wake_up_queue.hpp>
 
 namespace esl::computation {
     class environment;
+
+    class thread_pool;
 }
 
 namespace esl::simulation {
@@ -51,6 +54,11 @@ namespace esl::simulation {
         ///
         unsigned int rounds_;
 
+        ///
+        /// \brief  Runs the agents with `threads` > 1, together with the
+        ///         thread calling `step`. Created on first use.
+        ///
+        std::shared_ptr<computation::thread_pool> pool_;
 
 
     public:
@@ -112,10 +120,10 @@ namespace esl::simulation {
         std::uint64_t threads;
 
         ///
-        /// \brief  Stores the next wake-up time for each agent.
-        ///
+        /// \brief  Stores the next wake-up time for each agent, ordered so
+        ///         that the next event is found without scanning all agents.
         ///
-        boost::container::flat_map<identity<agent>, time_point> wake_up_times;
+        wake_up_queue wake_up_times;
 
         size_t messages_sent = 0;
 
@@ -0,0 +1,265 @@
+/// \file   wake_up_queue.hpp
+///
+/// \brief  The wake-up times of agents, in an indexed priority queue.
+///
+/// \authors    Maarten P. Scholl
+/// \date       2026-10-17
+/// \copyright  Copyright 2017-2026 The Institute for New Economic Thinking,
+///             Oxford Martin School, University of Oxford
+///
+///             Licensed under the Apache License, Version 2.0 (the "License");
+///             you may not use this file except in compliance with the License.
+///             You may obtain a copy of the License at
+///
+///                 http://www.apache.org/licenses/LICENSE-2.0
+///
+///             Unless required by applicable law or agreed to in writing,
+///             software distributed under the License is distributed on an "AS
+///             IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+///             express or implied. See the License for the specific language
+///             governing permissions and limitations under the License.
+///
+///             You may obtain instructions to fulfill the attribution
+///             requirements in CITATION.cff
+///
+#ifndef ESL_SIMULATION_WAKE_UP_QUEUE_HPP
+#define ESL_SIMULATION_WAKE_UP_QUEUE_HPP
+
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <esl/agent.hpp>
+#include <esl/simulation/identity.hpp>
+#include <esl/simulation/time.hpp>
+
+
+namespace esl::simulation {
+
+    ///
+    /// \brief  A binary min-heap of wake-up times, with an index from agent
+    ///         to heap position so that an agent's time can be changed in
+    ///         place.
+    ///
+    /// \details    The earliest wake-up time is available in constant time,
+    ///             and setting or lowering the time of an agent takes
+    ///             logarithmic time. Agents are given a slot when they are
+    ///             first scheduled, so that the heap itself only moves
+    ///             integers; slots are not reused.
+    ///
+    class wake_up_queue
+    {
+    public:
+        typedef std::uint32_t slot_t;
+
+    private:
+        constexpr static std::size_t unscheduled_ = std::numeric_limits<std::size_t>::max();
+
+        std::unordered_map<identity<agent>, slot_t> slots_;
+
+        std::vector<identity<agent>> agents_;
+
+        ///
+        /// \brief  Wake-up time, by slot
+        ///
+        std::vector<time_point> times_;
+
+        ///
+        /// \brief  Position in `heap_`, by slot
+        ///
+        std::vector<std::size_t> positions_;
+
+        std::vector<slot_t> heap_;
+
+        void place_(std::size_t position, slot_t slot)
+        {
+            heap_[position] = slot;
+            positions_[slot] = position;
+        }
+
+        void sift_up_(std::size_t position)
+        {
+            const auto slot_ = heap_[position];
+            while(0 < position){
+                auto parent_ = (position - 1) / 2;
+                if(times_[heap_[parent_]] <= times_[slot_]){
+                    break;
+                }
+                place_(position, heap_[parent_]);
+                position = parent_;
+            }
+            place_(position, slot_);
+        }
+
+        void sift_down_(std::size_t position)
+        {
+            const auto slot_ = heap_[position];
+            while(true){
+                auto child_ = 2 * position + 1;
+                if(heap_.size() <= child_){
+                    break;
+                }
+                if(child_ + 1 < heap_.size() && times_[heap_[child_ + 1]] < times_[heap_[child_]]){
+                    ++child_;
+                }
+                if(times_[slot_] <= times_[heap_[child_]]){
+                    break;
+                }
+                place_(position, heap_[child_]);
+                position = child_;
+            }
+            place_(position, slot_);
+        }
+
+        ///
+        /// \return the slot of the agent, which is pushed onto the heap at
+        ///         `time` if it was not scheduled
+        ///
+        std::pair<slot_t, bool> insert_(const identity<agent> &a, time_point time)
+        {
+            auto [i, inserted_] = slots_.try_emplace(a, static_cast<slot_t>(agents_.size()));
+            if(inserted_){
+                agents_.push_back(a);
+                times_.push_back(time);
+                positions_.push_back(unscheduled_);
+            }
+            const auto slot_ = i->second;
+            if(unscheduled_ != positions_[slot_]){
+                return {slot_, false};
+            }
+            times_[slot_] = time;
+            heap_.push_back(slot_);
+            sift_up_(heap_.size() - 1);
+            return {slot_, true};
+        }
+
+    public:
+        [[nodiscard]] bool empty() const
+        {
+            return heap_.empty();
+        }
+
+        ///
+        /// \brief  Number of agents scheduled
+        ///
+        [[nodiscard]] std::size_t size() const
+        {
+            return heap_.size();
+        }
+
+        ///
+        /// \brief  The earliest wake-up time, the queue must not be empty
+        ///
+        [[nodiscard]] time_point top() const
+        {
+            return times_[heap_.front()];
+        }
+
+        [[nodiscard]] std::optional<time_point> find(const identity<agent> &a) const
+        {
+            auto i = slots_.find(a);
+            if(slots_.end() == i || unscheduled_ == positions_[i->second]){
+                return {};
+            }
+            return times_[i->second];
+        }
+
+        [[nodiscard]] bool contains(const identity<agent> &a) const
+        {
+            return find(a).has_value();
+        }
+
+        ///
+        /// \brief  Sets the wake-up time of the agent, which may be later or
+        ///         earlier than its current time
+        ///
+        void set(const identity<agent> &a, time_point time)
+        {
+            auto [slot_, inserted_] = insert_(a, time);
+            if(inserted_){
+                return;
+            }
+            const auto previous_ = times_[slot_];
+            times_[slot_] = time;
+            if(time < previous_){
+                sift_up_(positions_[slot_]);
+            }else if(previous_ < time){
+                sift_down_(positions_[slot_]);
+            }
+        }
+
+        ///
+        /// \brief  Makes the agent wake up no later than `time`
+        ///
+        void decrease(const identity<agent> &a, time_point time)
+        {
+            auto [slot_, inserted_] = insert_(a, time);
+            if(!inserted_ && time < times_[slot_]){
+                times_[slot_] = time;
+                sift_up_(positions_[slot_]);
+            }
+        }
+
+        void erase(const identity<agent> &a)
+        {
+            auto i = slots_.find(a);
+            if(slots_.end() == i || unscheduled_ == positions_[i->second]){
+                return;
+            }
+            const auto position_ = positions_[i->second];
+            positions_[i->second] = unscheduled_;
+            const auto last_ = heap_.back();
+            heap_.pop_back();
+            if(position_ < heap_.size()){
+                place_(position_, last_);
+                sift_up_(position_);
+                sift_down_(positions_[last_]);
+            }
+        }
+
+        ///
+        /// \brief  Calls `f(agent, time)` for every agent that wakes up at
+        ///         or before `time`, in no particular order. Takes time
+        ///         proportional to the number of those agents.
+        ///
+        template<typename function_t_>
+        void due(time_point time, function_t_ f) const
+        {
+            if(heap_.empty()){
+                return;
+            }
+            std::vector<std::size_t> pending_ = {0};
+            while(!pending_.empty()){
+                auto position_ = pending_.back();
+                pending_.pop_back();
+                const auto slot_ = heap_[position_];
+                if(time < times_[slot_]){
+                    continue;
+                }
+                f(agents_[slot_], times_[slot_]);
+                for(auto child_: {2 * position_ + 1, 2 * position_ + 2}){
+                    if(child_ < heap_.size()){
+                        pending_.push_back(child_);
+                    }
+                }
+            }
+        }
+
+        ///
+        /// \brief  Calls `f(agent, time)` for every scheduled agent
+        ///
+        template<typename function_t_>
+        void for_each(function_t_ f) const
+        {
+            for(auto slot_: heap_){
+                f(agents_[slot_], times_[slot_]);
+            }
+        }
+    };
+
+}  // namespace esl::simulation
+
+#endif  // ESL_SIMULATION_WAKE_UP_QUEUE_HPP
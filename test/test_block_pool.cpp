@@ -31,6 +31,8 @@
 
 #include <boost/test/included/unit_test.hpp>
 
+#include <vector>
+
 #include <esl/computation/block_pool.hpp>
 
 
@@ -61,4 +63,91 @@ BOOST_AUTO_TEST_SUITE(ESL)
         }
     }
 
+    BOOST_AUTO_TEST_CASE(block_pool_find)
+    {
+        esl::computation::block_pool::static_block_pool<int> bp_(4);
+
+        BOOST_CHECK(!bp_.find(0));
+
+        auto a = bp_.emplace(7);
+        BOOST_CHECK(bp_.find(a.first));
+        BOOST_CHECK_EQUAL(bp_.find(a.first)->data, 7);
+
+        BOOST_CHECK_EQUAL(bp_.erase(a.first), 1);
+        BOOST_CHECK(!bp_.find(a.first));
+        // erasing a stale index does not release the block a second time
+        BOOST_CHECK_EQUAL(bp_.erase(a.first), 0);
+        BOOST_CHECK_EQUAL(bp_.size(), 0);
+    }
+
+    BOOST_AUTO_TEST_CASE(block_pool_position)
+    {
+        esl::computation::block_pool::static_block_pool<int> bp_(4);
+
+        auto a = bp_.emplace(1);
+        auto b = bp_.emplace(2);
+        BOOST_CHECK_EQUAL(bp_.block_at(bp_.position(a.second)), a.second);
+        BOOST_CHECK_EQUAL(bp_.block_at(bp_.position(b.second))->data, 2);
+
+        // the position of a block is reused, the index is not
+        bp_.erase(a.first);
+        auto c = bp_.emplace(3);
+        BOOST_CHECK_EQUAL(bp_.position(c.second), bp_.position(a.second));
+        BOOST_CHECK_NE(c.first, a.first);
+    }
+
+    BOOST_AUTO_TEST_CASE(block_pool_slabs)
+    {
+        esl::computation::block_pool::static_block_pool<int> bp_(10, 4);
+        BOOST_CHECK_EQUAL(bp_.constructed(), 4);
+
+        std::vector<std::pair<std::uint64_t, esl::computation::block_pool::block<int> *>> placed_;
+        for(int i = 0; i < 10; ++i){
+            placed_.push_back(bp_.emplace(i));
+            // indices are the same as for a pool that is constructed at once
+            BOOST_CHECK_EQUAL(placed_.back().first, i);
+        }
+        // the last slab is shortened to the capacity
+        BOOST_CHECK_EQUAL(bp_.constructed(), 10);
+        BOOST_CHECK_THROW(bp_.emplace(10), std::exception);
+
+        // blocks in earlier slabs have not moved
+        for(int i = 0; i < 10; ++i){
+            BOOST_CHECK_EQUAL(bp_.find(placed_[i].first), placed_[i].second);
+            BOOST_CHECK_EQUAL(placed_[i].second->data, i);
+        }
+
+        BOOST_CHECK_EQUAL(bp_.erase(2), 1);
+        BOOST_CHECK_EQUAL(bp_.erase(7), 1);
+        BOOST_CHECK_EQUAL(bp_.high_water(), 10);
+        BOOST_CHECK_CLOSE(bp_.occupancy(), 0.8, 1e-9);
+        BOOST_CHECK_EQUAL(bp_.memory(), 10 * sizeof(esl::computation::block_pool::block<int>));
+    }
+
+    BOOST_AUTO_TEST_CASE(block_pool_unconstructed)
+    {
+        esl::computation::block_pool::static_block_pool<int> bp_(1024, 16);
+        bp_.emplace(1);
+        // indices that map to blocks that are not constructed are not found
+        BOOST_CHECK(!bp_.find(100));
+        BOOST_CHECK_EQUAL(bp_.erase(100), 0);
+        BOOST_CHECK_EQUAL(bp_.constructed(), 16);
+        BOOST_CHECK_EQUAL(bp_.size(), 1);
+    }
+
+    BOOST_AUTO_TEST_CASE(block_pool_huge_pages)
+    {
+        // huge pages are only requested for large pools, and are advisory
+        typedef esl::computation::block_pool::static_block_pool<std::uint64_t> pool_t;
+        pool_t small_(16, 0, true);
+        BOOST_CHECK(!small_.huge_pages());
+
+        pool_t large_(pool_t::huge_page_size, 1024, true);
+        for(std::uint64_t i = 0; i < 4096; ++i){
+            BOOST_CHECK_EQUAL(large_.emplace(i).first, i);
+        }
+        BOOST_CHECK_EQUAL(large_.find(4095)->data, 4095);
+        BOOST_CHECK_EQUAL(large_.constructed(), 4096);
+    }
+
 BOOST_AUTO_TEST_SUITE_END()  // ESL
@@ -0,0 +1,100 @@
+/// \file   test_columnar_log.cpp
+///
+/// \brief
+///
+/// \authors    Maarten P. Scholl
+/// \date       2026-10-17
+/// \copyright  Copyright 2017-2026 The Institute for New Economic Thinking,
+///             Oxford Martin School, University of Oxford
+///
+///             Licensed under the Apache License, Version 2.0 (the "License");
+///             you may not use this file except in compliance with the License.
+///             You may obtain a copy of the License at
+///
+///                 http://www.apache.org/licenses/LICENSE-2.0
+///
+///             Unless required by applicable law or agreed to in writing,
+///             software distributed under the License is distributed on an "AS
+///             IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+///             express or implied. See the License for the specific language
+///             governing permissions and limitations under the License.
+///
+///             You may obtain instructions to fulfill the attribution
+///             requirements in CITATION.cff
+///
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE columnar_log
+
+#include <boost/test/included/unit_test.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <vector>
+
+#include <esl/data/format/columnar_log.hpp>
+
+using namespace esl;
+using namespace esl::data;
+
+
+typedef columnar_log<std::uint64_t, std::uint8_t, std::int64_t> log_t;
+
+BOOST_AUTO_TEST_SUITE(ESL)
+
+    BOOST_AUTO_TEST_CASE(columnar_log_blocks)
+    {
+        {
+            log_t log_("test_columnar_log.bin", {"time", "side", "price"}, 3);
+            for(std::uint64_t i = 0; i < 7; ++i){
+                log_.append(i, std::uint8_t(i % 2), -100 * std::int64_t(i));
+            }
+            // two full blocks are written, the last row on destruction
+            BOOST_CHECK_EQUAL(log_.rows, 6);
+            BOOST_CHECK_EQUAL(log_.blocks, 2);
+            BOOST_CHECK_EQUAL(log_.buffered(), 1);
+        }
+
+        std::vector<std::size_t> blocks_;
+        std::vector<std::int64_t> prices_;
+        auto rows_ = log_t::read("test_columnar_log.bin", [&](std::size_t rows
+                                                            , const std::uint64_t *time
+                                                            , const std::uint8_t *side
+                                                            , const std::int64_t *price){
+            blocks_.push_back(rows);
+            for(std::size_t i = 0; i < rows; ++i){
+                BOOST_CHECK_EQUAL(side[i], time[i] % 2);
+                prices_.push_back(price[i]);
+            }
+        });
+        BOOST_CHECK_EQUAL(rows_, 7);
+        BOOST_CHECK((blocks_ == std::vector<std::size_t>{3, 3, 1}));
+        BOOST_CHECK_EQUAL(prices_.back(), -600);
+
+        // a log with different columns is rejected
+        BOOST_CHECK_THROW((columnar_log<std::uint64_t, std::uint8_t>::read("test_columnar_log.bin", [](auto...){}))
+                         , esl::exception);
+        std::remove("test_columnar_log.bin");
+    }
+
+    BOOST_AUTO_TEST_CASE(columnar_log_truncated)
+    {
+        {
+            log_t log_("test_columnar_log_truncated.bin", {"time", "side", "price"});
+            log_.append(1, 0, 10);
+            log_.append(2, 1, 20);
+        }
+        {
+            // cut into the last column of the block
+            std::ifstream input_("test_columnar_log_truncated.bin", std::ios::binary | std::ios::ate);
+            std::vector<char> contents_(std::size_t(input_.tellg()));
+            input_.seekg(0);
+            input_.read(contents_.data(), contents_.size());
+            input_.close();
+            std::ofstream output_("test_columnar_log_truncated.bin", std::ios::binary | std::ios::trunc);
+            output_.write(contents_.data(), contents_.size() - 4);
+        }
+        BOOST_CHECK_THROW(log_t::read("test_columnar_log_truncated.bin", [](auto...){}), esl::exception);
+        std::remove("test_columnar_log_truncated.bin");
+    }
+
+BOOST_AUTO_TEST_SUITE_END()  // ESL
@@ -44,14 +44,33 @@ struct test_agent
 
     unsigned int delay = 0;
 
+    unsigned int acted = 0;
+
     time_point act(time_interval step,
                                     std::seed_seq &seed) override
     {
         (void) seed;
+        ++acted;
         return step.lower + delay;
     }
 };
 
+///
+/// \brief  Wakes up before the current time, which is an error, after the
+///         first time point
+///
+struct failing_agent
+: public agent
+{
+    using agent::agent;
+
+    time_point act(time_interval step, std::seed_seq &seed) override
+    {
+        (void) seed;
+        return 0 == step.lower ? 1 : step.lower - 1;
+    }
+};
+
 
 struct test_model
     : public model
@@ -145,4 +164,47 @@ BOOST_AUTO_TEST_SUITE(ESL)
         BOOST_CHECK_EQUAL(next_, 8);
     }
 
+    BOOST_AUTO_TEST_CASE(environment_activation)
+    {
+        computation::environment e;
+        test_model tm(e, parameter::parametrization(0, 0, 100));
+
+        auto a1 = tm.create<test_agent>();
+        a1->delay = 2;
+        auto a2 = tm.create<test_agent>();
+        a2->delay = 3;
+        BOOST_CHECK_EQUAL(tm.step({0, 100}), 2);
+
+        // a deactivated agent is no longer scheduled, and a new agent acts
+        // at the next step
+        tm.agents.deactivate(a1);
+        auto a3 = tm.create<test_agent>();
+        a3->delay = 5;
+        BOOST_CHECK_EQUAL(tm.step({1, 100}), 3);
+        BOOST_CHECK_EQUAL(a1->acted, 1);
+        BOOST_CHECK_EQUAL(a3->acted, 1);
+        BOOST_CHECK_EQUAL(tm.step({3, 100}), 6);
+        BOOST_CHECK_EQUAL(a2->acted, 2);
+        BOOST_CHECK_EQUAL(tm.wake_up_times.size(), 2);
+    }
+
+    ///
+    /// \brief  An agent that fails on a worker thread stops the step
+    ///
+    BOOST_AUTO_TEST_CASE(environment_run_agents_parallel_error)
+    {
+        computation::environment e;
+        test_model tm(e, parameter::parametrization(0, 0, 100, 0, 4));
+
+        for(auto i = 0; i < 1'000; ++i){
+            auto a1 = tm.create<test_agent>();
+            a1->delay = 1;
+        }
+        tm.create<failing_agent>();
+        auto next_ = tm.step({0, 1});
+        BOOST_CHECK_EQUAL(next_, 1);
+
+        BOOST_CHECK_THROW(tm.step({1, 2}), std::logic_error);
+    }
+
 BOOST_AUTO_TEST_SUITE_END()  // ESL
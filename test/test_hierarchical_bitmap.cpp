@@ -0,0 +1,116 @@
+/// \file   test_hierarchical_bitmap.cpp
+///
+/// \brief
+///
+/// \authors    Maarten P. Scholl
+/// \date       2026-10-17
+/// \copyright  Copyright 2017-2026 The Institute for New Economic Thinking,
+///             Oxford Martin School, University of Oxford
+///
+///             Licensed under the Apache License, Version 2.0 (the "License");
+///             you may not use this file except in compliance with the License.
+///             You may obtain a copy of the License at
+///
+///                 http://www.apache.org/licenses/LICENSE-2.0
+///
+///             Unless required by applicable law or agreed to in writing,
+///             software distributed under the License is distributed on an "AS
+///             IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+///             express or implied. See the License for the specific language
+///             governing permissions and limitations under the License.
+///
+///             You may obtain instructions to fulfill the attribution
+///             requirements in CITATION.cff
+///
+
+
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE hierarchical_bitmap
+
+
+#include <boost/test/included/unit_test.hpp>
+
+#include <esl/computation/hierarchical_bitmap.hpp>
+
+
+BOOST_AUTO_TEST_SUITE(ESL)
+
+    BOOST_AUTO_TEST_CASE(hierarchical_bitmap_empty)
+    {
+        esl::computation::hierarchical_bitmap b_(100'000);
+
+        BOOST_CHECK(b_.empty());
+        BOOST_CHECK_EQUAL(b_.next(0), esl::computation::hierarchical_bitmap::npos);
+        BOOST_CHECK_EQUAL(b_.previous(99'999), esl::computation::hierarchical_bitmap::npos);
+    }
+
+    BOOST_AUTO_TEST_CASE(hierarchical_bitmap_next_previous)
+    {
+        constexpr auto npos = esl::computation::hierarchical_bitmap::npos;
+        esl::computation::hierarchical_bitmap b_(300'000);
+
+        b_.set(5);
+        b_.set(4'096);
+        b_.set(262'143);
+        b_.set(299'999);
+
+        BOOST_CHECK(!b_.empty());
+        BOOST_CHECK(b_.test(4'096));
+        BOOST_CHECK(!b_.test(4'097));
+
+        BOOST_CHECK_EQUAL(b_.next(0), 5);
+        BOOST_CHECK_EQUAL(b_.next(5), 5);
+        BOOST_CHECK_EQUAL(b_.next(6), 4'096);
+        BOOST_CHECK_EQUAL(b_.next(4'097), 262'143);
+        BOOST_CHECK_EQUAL(b_.next(262'144), 299'999);
+        BOOST_CHECK_EQUAL(b_.next(300'000), npos);
+
+        BOOST_CHECK_EQUAL(b_.previous(299'999), 299'999);
+        BOOST_CHECK_EQUAL(b_.previous(299'998), 262'143);
+        BOOST_CHECK_EQUAL(b_.previous(262'142), 4'096);
+        BOOST_CHECK_EQUAL(b_.previous(4'095), 5);
+        BOOST_CHECK_EQUAL(b_.previous(4), npos);
+
+        b_.reset(4'096);
+        BOOST_CHECK_EQUAL(b_.next(6), 262'143);
+        BOOST_CHECK_EQUAL(b_.previous(262'142), 5);
+
+        b_.reset(5);
+        b_.reset(262'143);
+        b_.reset(299'999);
+        BOOST_CHECK(b_.empty());
+    }
+
+    BOOST_AUTO_TEST_CASE(hierarchical_bitmap_matches_linear_scan)
+    {
+        constexpr size_t size_ = 10'000;
+        esl::computation::hierarchical_bitmap b_(size_);
+        std::vector<bool> reference_(size_, false);
+
+        std::uint64_t state_ = 1;
+        for(size_t i = 0; i < 20'000; ++i){
+            state_ = state_ * 6364136223846793005ull + 1442695040888963407ull;
+            auto position_ = (state_ >> 33) % size_;
+            if(reference_[position_]){
+                b_.reset(position_);
+            }else{
+                b_.set(position_);
+            }
+            reference_[position_] = !reference_[position_];
+
+            auto query_ = (state_ >> 13) % size_;
+            auto next_ = esl::computation::hierarchical_bitmap::npos;
+            for(auto j = query_; j < size_; ++j){
+                if(reference_[j]){ next_ = j; break; }
+            }
+            auto previous_ = esl::computation::hierarchical_bitmap::npos;
+            for(auto j = query_ + 1; j > 0; --j){
+                if(reference_[j - 1]){ previous_ = j - 1; break; }
+            }
+            BOOST_REQUIRE_EQUAL(b_.next(query_), next_);
+            BOOST_REQUIRE_EQUAL(b_.previous(query_), previous_);
+        }
+    }
+
+BOOST_AUTO_TEST_SUITE_END()  // ESL
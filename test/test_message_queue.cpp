@@ -0,0 +1,100 @@
+/// \file   test_message_queue.cpp
+///
+/// \brief
+///
+/// \authors    Maarten P. Scholl
+/// \date       2026-10-17
+/// \copyright  Copyright 2017-2026 The Institute for New Economic Thinking,
+///             Oxford Martin School, University of Oxford
+///
+///             Licensed under the Apache License, Version 2.0 (the "License");
+///             you may not use this file except in compliance with the License.
+///             You may obtain a copy of the License at
+///
+///                 http://www.apache.org/licenses/LICENSE-2.0
+///
+///             Unless required by applicable law or agreed to in writing,
+///             software distributed under the License is distributed on an "AS
+///             IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+///             express or implied. See the License for the specific language
+///             governing permissions and limitations under the License.
+///
+///             You may obtain instructions to fulfill the attribution
+///             requirements in CITATION.cff
+///
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE message_queue
+
+#include <boost/test/included/unit_test.hpp>
+
+#include <vector>
+
+#include <esl/interaction/message_queue.hpp>
+
+using namespace esl;
+using namespace esl::interaction;
+
+
+std::vector<header *> contents(const message_queue &queue)
+{
+    std::vector<header *> result_;
+    for(const auto &[k, m]: queue){
+        (void) k;
+        result_.push_back(m.get());
+    }
+    return result_;
+}
+
+BOOST_AUTO_TEST_SUITE(ESL)
+
+    BOOST_AUTO_TEST_CASE(message_queue_order)
+    {
+        message_queue queue_;
+        std::vector<std::shared_ptr<header>> messages_;
+        for(unsigned int i = 0; i < 5; ++i){
+            messages_.push_back(std::make_shared<header>());
+        }
+
+        queue_.insert({3, messages_[0]});
+        queue_.insert({5, messages_[1]});
+        // out of order, after the message with the same delivery time
+        queue_.insert({3, messages_[2]});
+        queue_.emplace(1, messages_[3]);
+        queue_.insert({5, messages_[4]});
+
+        BOOST_CHECK_EQUAL(queue_.size(), 5);
+        BOOST_CHECK(contents(queue_) == (std::vector<header *>{ messages_[3].get()
+                                                              , messages_[0].get()
+                                                              , messages_[2].get()
+                                                              , messages_[1].get()
+                                                              , messages_[4].get()}));
+        BOOST_CHECK(queue_.find(3)->second == messages_[0]);
+        BOOST_CHECK(queue_.find(4) == queue_.end());
+
+        queue_.consume(3);
+        BOOST_CHECK_EQUAL(queue_.size(), 2);
+        BOOST_CHECK_EQUAL(queue_.begin()->first, 5);
+        BOOST_CHECK(queue_.find(1) == queue_.end());
+        // consumed messages are released
+        BOOST_CHECK_EQUAL(messages_[0].use_count(), 1);
+
+        BOOST_CHECK_EQUAL(queue_.erase(5), 2);
+        BOOST_CHECK(queue_.empty());
+    }
+
+    BOOST_AUTO_TEST_CASE(message_queue_consume)
+    {
+        message_queue queue_;
+        auto message_ = std::make_shared<header>();
+        for(simulation::time_point t = 0; t < 1'000; ++t){
+            queue_.insert({t + 100, message_});
+            queue_.consume(t);
+            BOOST_REQUIRE_EQUAL(queue_.size(), std::min<simulation::time_point>(t + 1, 100));
+            BOOST_REQUIRE_GT(queue_.begin()->first, t);
+        }
+        queue_.consume(2'000);
+        BOOST_CHECK(queue_.empty());
+        BOOST_CHECK_EQUAL(message_.use_count(), 1);
+    }
+
+BOOST_AUTO_TEST_SUITE_END()  // ESL
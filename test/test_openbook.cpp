@@ -0,0 +1,183 @@
+/// \file   test_openbook.cpp
+///
+/// \brief
+///
+/// \authors    Maarten P. Scholl
+/// \date       2026-10-17
+/// \copyright  Copyright 2017-2026 The Institute for New Economic Thinking,
+///             Oxford Martin School, University of Oxford
+///
+///             Licensed under the Apache License, Version 2.0 (the "License");
+///             you may not use this file except in compliance with the License.
+///             You may obtain a copy of the License at
+///
+///                 http://www.apache.org/licenses/LICENSE-2.0
+///
+///             Unless required by applicable law or agreed to in writing,
+///             software distributed under the License is distributed on an "AS
+///             IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+///             express or implied. See the License for the specific language
+///             governing permissions and limitations under the License.
+///
+///             You may obtain instructions to fulfill the attribution
+///             requirements in CITATION.cff
+///
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE openbook
+
+#include <boost/test/included/unit_test.hpp>
+
+#include <array>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <boost/iostreams/device/file.hpp>
+#include <boost/iostreams/filter/gzip.hpp>
+#include <boost/iostreams/filtering_stream.hpp>
+
+#include <esl/data/format/openbook_reader.hpp>
+#include <esl/economics/markets/order_book/openbook_replay.hpp>
+
+using namespace esl;
+using namespace esl::data;
+using namespace esl::economics;
+using namespace esl::economics::markets;
+using namespace esl::economics::markets::order_book;
+
+
+///
+/// \brief  Writes an OpenBook 1.2b message, with the price at scale 2
+///
+std::array<char, openbook_record_size> record( std::uint16_t type
+                                             , const std::string &symbol
+                                             , std::uint32_t cents
+                                             , std::uint32_t quantity
+                                             , char side
+                                             , char reason
+                                             )
+{
+    std::array<char, openbook_record_size> result_;
+    result_.fill(' ');
+    auto store_ = [&](std::size_t offset, std::uint64_t value, std::size_t bytes){
+        for(std::size_t i = 0; i < bytes; ++i){
+            result_[offset + bytes - 1 - i] = char(value >> (8 * i));
+        }
+    };
+    store_(4, type, 2);
+    for(std::size_t i = 0; i < symbol.size(); ++i){
+        result_[10 + i] = symbol[i];
+    }
+    store_(27, 34'200'000, 4); // 09:30
+    store_(31, 17, 2);
+    result_[34] = 'O';
+    result_[40] = 2;
+    store_(41, cents, 4);
+    store_(45, 0, 4);
+    store_(49, quantity, 4);
+    result_[55] = side;
+    result_[57] = reason;
+    return result_;
+}
+
+std::vector<std::array<char, openbook_record_size>> session()
+{
+    return { record(2, "", 0, 0, ' ', ' ')   // heartbeat
+           , record(230, "ABC", 10'00, 300, 'B', 'O')
+           , record(231, "ABC", 10'00, 200, 'B', 'O')
+           , record(231, "XYZ", 20'00, 400, 'S', 'O')
+           , record(231, "ABC", 10'05, 100, 'S', 'O')
+           , record(231, "ABC", 10'00, 250, 'B', 'C')
+           , record(231, "ABC", 10'05, 100, 'S', 'E')
+           };
+}
+
+void write(const std::string &filename, bool compressed)
+{
+    boost::iostreams::filtering_ostream output_;
+    if(compressed){
+        output_.push(boost::iostreams::gzip_compressor());
+    }
+    output_.push(boost::iostreams::file_sink(filename, std::ios::binary));
+    for(const auto &r: session()){
+        output_.write(r.data(), r.size());
+    }
+    // a partial message, which is ignored
+    output_.write("ABC", 3);
+}
+
+std::vector<openbook_event> read_all(openbook_reader &reader)
+{
+    std::vector<openbook_event> result_;
+    reader.read([&](const openbook_event *first, const openbook_event *last){
+        BOOST_CHECK_LE(last - first, 2);
+        result_.insert(result_.end(), first, last);
+    }, 2);
+    return result_;
+}
+
+BOOST_AUTO_TEST_SUITE(ESL)
+
+    BOOST_AUTO_TEST_CASE(openbook_read)
+    {
+        for(bool compressed_: {false, true}){
+            std::string filename_ = compressed_ ? "test_openbook.bin.gz" : "test_openbook.bin";
+            write(filename_, compressed_);
+
+            openbook_reader reader_(filename_);
+            auto events_ = read_all(reader_);
+            std::remove(filename_.c_str());
+
+            BOOST_CHECK_EQUAL(reader_.records, 7);
+            BOOST_REQUIRE_EQUAL(events_.size(), 6);
+            BOOST_CHECK_EQUAL(reader_.parser.symbols.size(), 2);
+            BOOST_CHECK_EQUAL(reader_.parser.symbols[events_[0].symbol], "ABC");
+            BOOST_CHECK_EQUAL(reader_.parser.symbols[events_[2].symbol], "XYZ");
+            BOOST_CHECK_EQUAL(events_[0].symbol, events_[3].symbol);
+
+            BOOST_CHECK_EQUAL(events_[0].time, 34'200'000'017ull);
+            BOOST_CHECK_EQUAL(events_[0].trading_status, 'O');
+            BOOST_CHECK_EQUAL(events_[0].price_numerator, 10'00);
+            BOOST_CHECK_EQUAL(events_[0].price_scale, 2);
+            BOOST_CHECK_EQUAL(events_[0].quantity, 300);
+            BOOST_CHECK_EQUAL(events_[0].side, limit_order::buy);
+            BOOST_CHECK_EQUAL(events_[2].side, limit_order::sell);
+            BOOST_CHECK_EQUAL(events_[4].reason, 'C');
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE(openbook_replay_engine)
+    {
+        write("test_openbook_replay.bin", false);
+        openbook_reader reader_("test_openbook_replay.bin");
+        matching_engine engine_;
+        openbook_replay replay_(engine_);
+        replay_.symbol_ticker = [](const std::string &symbol, std::uint32_t){
+            return ticker(identity<law::property>{std::uint64_t(symbol[0])});
+        };
+
+        BOOST_CHECK_EQUAL(replay_.replay(reader_), 6);
+        std::remove("test_openbook_replay.bin");
+
+        BOOST_CHECK_EQUAL(replay_.inserted, 4);
+        BOOST_CHECK_EQUAL(replay_.removed, 2);
+        BOOST_CHECK_EQUAL(engine_.books.size(), 2);
+
+        auto lot_ = 100 * currencies::USD.denominator;
+        auto &abc_ = *engine_.books.find(ticker(identity<law::property>{std::uint64_t('A')}))->second;
+
+        // the cancellation removes the newest order, and 50 of the oldest
+        auto bids_ = abc_.depth(limit_order::buy, 5);
+        BOOST_REQUIRE_EQUAL(bids_.size(), 1);
+        BOOST_CHECK_EQUAL(bids_[0].quantity, 250);
+        BOOST_CHECK_EQUAL(bids_[0].orders, 1);
+        BOOST_CHECK(bids_[0].limit == quote(price(10'00 * lot_, currencies::USD), lot_));
+        BOOST_CHECK(abc_.depth(limit_order::sell, 5).empty());
+        BOOST_CHECK(abc_.reports.empty());
+
+        auto &xyz_ = *engine_.books.find(ticker(identity<law::property>{std::uint64_t('X')}))->second;
+        BOOST_CHECK_EQUAL(xyz_.depth(limit_order::sell, 5).at(0).quantity, 400);
+    }
+
+BOOST_AUTO_TEST_SUITE_END()  // ESL
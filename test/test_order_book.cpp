@@ -24,6 +24,9 @@
 ///
 #include <set>
 #include <cmath>
+#include <map>
+#include <random>
+#include <sstream>
 
 #define BOOST_TEST_DYN_LINK
 #define BOOST_TEST_MODULE order_book
@@ -35,7 +38,12 @@
 #define protected public
 #include <esl/economics/currencies.hpp>
 #include <esl/economics/markets/order_book/binary_tree_order_book.hpp>
+#include <esl/economics/markets/order_book/call_auction.hpp>
 #include <esl/economics/markets/order_book/static_order_book.hpp>
+#include <esl/economics/markets/order_book/paged_order_book.hpp>
+#include <esl/economics/markets/order_book/matching_engine.hpp>
+#include <esl/economics/markets/order_book/sharded_matching_engine.hpp>
+#include <esl/economics/markets/participant_registry.hpp>
 #undef private
 #undef protected
 #include <esl/data/representation.hpp>
@@ -329,6 +337,690 @@ BOOST_AUTO_TEST_SUITE(ESL)
         BOOST_CHECK_EQUAL(book_.bid().value(), quote(price::approximate(4.75, currencies::USD), 100 *  currencies::USD.denominator));
     }
 
+    ///
+    /// \brief  Aggressive orders that empty a level must find the next best
+    ///         level, even when it is many ticks away.
+    ///
+    BOOST_AUTO_TEST_CASE(statically_allocated_book_sparse_sweep)
+    {
+        auto  min_ = quote(price::approximate(0.01, currencies::USD), 100 *  currencies::USD.denominator);
+        auto  max_ = quote(price::approximate(10.00, currencies::USD), 100 *  currencies::USD.denominator);
+        auto book_ = markets::order_book::static_order_book(min_, max_);
+
+        book_.insert(create_ask(1.00, 100));
+        book_.insert(create_ask(9.00, 100));
+        book_.insert(create_bid(0.02, 100));
+
+        book_.insert(create_bid(9.50, 150));    // expect: execute 100 at 1.00 and 50 at 9.00
+        BOOST_CHECK_EQUAL(book_.ask().value(), quote(price::approximate(9.00, currencies::USD), 100 *  currencies::USD.denominator));
+        BOOST_CHECK_EQUAL(book_.bid().value(), quote(price::approximate(0.02, currencies::USD), 100 *  currencies::USD.denominator));
+
+        book_.insert(create_bid(9.00, 50));     // expect: the ask side is empty
+        BOOST_CHECK(!book_.ask());
+
+        book_.insert(create_ask(0.01, 100));    // expect: the bid side is empty
+        BOOST_CHECK(!book_.bid());
+        BOOST_CHECK(!book_.ask());
+        BOOST_CHECK(book_.orders().empty());
+    }
+
+    ///
+    /// \brief  Cancelling orders at the front, middle and back of a queue
+    ///         keeps the queue linked, and updates best prices and
+    ///         level aggregates.
+    ///
+    BOOST_AUTO_TEST_CASE(statically_allocated_book_cancel)
+    {
+        auto  min_ = quote(price::approximate(0.01, currencies::USD), 100 *  currencies::USD.denominator);
+        auto  max_ = quote(price::approximate(10.00, currencies::USD), 100 *  currencies::USD.denominator);
+        auto book_ = markets::order_book::static_order_book(min_, max_);
+
+        book_.insert(create_bid(4.75, 100));
+        book_.insert(create_bid(4.75, 200));
+        book_.insert(create_bid(4.75, 300));
+        book_.insert(create_bid(4.70, 400));
+        BOOST_CHECK_EQUAL(book_.reports.size(), 4);
+        auto front_  = book_.reports[0].identifier;
+        auto middle_ = book_.reports[1].identifier;
+        auto back_   = book_.reports[2].identifier;
+        auto lower_  = book_.reports[3].identifier;
+
+        book_.cancel(middle_);
+        BOOST_CHECK_EQUAL(book_.reports.back().state, execution_report::cancel);
+        BOOST_CHECK_EQUAL(book_.reports.back().side, limit_order::buy);
+        BOOST_CHECK_EQUAL(book_.reports.back().quantity, 200);
+        BOOST_CHECK_EQUAL(book_.best_bid_->quantity, 400);
+        BOOST_CHECK_EQUAL(book_.best_bid_->orders, 2);
+
+        // cancelling twice has no effect
+        book_.cancel(middle_);
+        BOOST_CHECK_EQUAL(book_.reports.size(), 5);
+
+        // the queue is intact: the sell order matches front_ and then back_
+        book_.insert(create_ask(4.75, 150));
+        BOOST_CHECK_EQUAL(book_.reports[6].identifier, front_);
+        BOOST_CHECK_EQUAL(book_.reports[8].identifier, back_);
+        BOOST_CHECK_EQUAL(book_.reports[8].quantity, 50);
+
+        // cancelling the last order at the best level moves the best bid
+        book_.cancel(back_);
+        BOOST_CHECK_EQUAL(book_.bid().value(), quote(price::approximate(4.70, currencies::USD), 100 *  currencies::USD.denominator));
+
+        book_.insert(create_ask(5.00, 100));
+        auto ask_ = book_.reports.back().identifier;
+        book_.cancel(ask_);
+        BOOST_CHECK_EQUAL(book_.reports.back().side, limit_order::sell);
+        BOOST_CHECK(!book_.ask());
+
+        book_.cancel(lower_);
+        BOOST_CHECK(!book_.bid());
+        BOOST_CHECK(book_.orders().empty());
+        BOOST_CHECK_EQUAL(book_.pool_.size(), 0);
+    }
+
+    ///
+    /// \brief  The integer price codec maps every representable price in
+    ///         the interval to its own level, and back.
+    ///
+    BOOST_AUTO_TEST_CASE(statically_allocated_book_tick_codec)
+    {
+        auto  min_ = quote(price::approximate(0.01, currencies::USD), 100 *  currencies::USD.denominator);
+        auto  max_ = quote(price::approximate(10.00, currencies::USD), 100 *  currencies::USD.denominator);
+        auto book_ = markets::order_book::basic_static_order_book<tick_price_codec>(min_, max_);
+
+        BOOST_CHECK_EQUAL(book_.limits_.size(), 1000);
+
+        for(std::int64_t cents_ = 1; cents_ <= 1000; ++cents_){
+            auto q = quote(price(cents_, currencies::USD), 100 *  currencies::USD.denominator);
+            markets::order_book::static_order_book::limit l;
+            BOOST_CHECK(book_.codec_.encode(q, l));
+            BOOST_CHECK_EQUAL(l, cents_ - 1);
+            BOOST_CHECK_EQUAL(book_.codec_.decode(l), q);
+        }
+
+        markets::order_book::static_order_book::limit l;
+        BOOST_CHECK(!book_.codec_.encode(quote(price(1001, currencies::USD), 100 *  currencies::USD.denominator), l));
+        BOOST_CHECK(!book_.codec_.encode(quote(price(500, currencies::USD), 1), l));
+
+        // the maximum is a valid limit price
+        book_.insert(create_ask(10.00, 100));
+        book_.insert(create_bid(4.75, 100));
+        BOOST_CHECK_EQUAL(book_.ask().value(), max_);
+        book_.insert(create_bid(10.00, 60));
+        BOOST_CHECK_EQUAL(book_.reports.back().state, execution_report::match);
+        BOOST_CHECK_EQUAL(book_.reports.back().limit, max_);
+        BOOST_CHECK_EQUAL(book_.best_ask_->quantity, 40);
+    }
+
+    BOOST_AUTO_TEST_CASE(statically_allocated_book_resize)
+    {
+        auto  min_ = quote(price::approximate(1.00, currencies::USD), 100 *  currencies::USD.denominator);
+        auto  max_ = quote(price::approximate(2.00, currencies::USD), 100 *  currencies::USD.denominator);
+        auto book_ = markets::order_book::basic_static_order_book<tick_price_codec>(min_, max_);
+
+        book_.insert(create_bid(1.05, 100));
+        book_.insert(create_bid(1.40, 200));
+        book_.insert(create_ask(1.60, 300));
+        book_.insert(create_ask(1.95, 400));
+        book_.reports.clear();
+
+        // shift the window up, cutting off the lowest bid
+        auto lower_ = quote(price::approximate(1.25, currencies::USD), 100 *  currencies::USD.denominator);
+        auto upper_ = quote(price::approximate(2.50, currencies::USD), 100 *  currencies::USD.denominator);
+        book_.resize(mathematics::interval<quote>(lower_, upper_));
+
+        BOOST_CHECK_EQUAL(book_.limits_.size(), 126);
+        BOOST_CHECK_EQUAL(book_.reports.size(), 1);
+        BOOST_CHECK_EQUAL(book_.reports.back().state, execution_report::cancel);
+        BOOST_CHECK_EQUAL(book_.reports.back().quantity, 100);
+        BOOST_CHECK_EQUAL(book_.orders().size(), 3);
+
+        BOOST_CHECK_EQUAL(book_.bid().value(), create_bid(1.40).limit);
+        BOOST_CHECK_EQUAL(book_.ask().value(), create_ask(1.60).limit);
+        BOOST_CHECK_EQUAL(book_.best_bid_->quantity, 200);
+
+        // resting orders can still be matched after moving
+        book_.insert(create_bid(2.00, 700));
+        BOOST_CHECK(!book_.ask().has_value());
+        BOOST_CHECK_EQUAL(book_.orders().size(), 1);
+
+        // the new upper limit is valid
+        book_.insert(create_ask(2.50, 10));
+        BOOST_CHECK_EQUAL(book_.ask().value(), upper_);
+    }
+
+    BOOST_AUTO_TEST_CASE(statically_allocated_book_recentre)
+    {
+        auto  min_ = quote(price::approximate(1.00, currencies::USD), 100 *  currencies::USD.denominator);
+        auto  max_ = quote(price::approximate(2.00, currencies::USD), 100 *  currencies::USD.denominator);
+        auto book_ = markets::order_book::basic_static_order_book<tick_price_codec>(min_, max_);
+
+        // rejected by default
+        book_.insert(create_bid(2.50, 100));
+        BOOST_CHECK_EQUAL(book_.reports.back().state, execution_report::invalid);
+        book_.reports.clear();
+
+        book_.recentring.enabled = true;
+        book_.insert(create_bid(1.50, 100));
+
+        // the window is moved without growing
+        book_.insert(create_ask(2.30, 100));
+        BOOST_CHECK_EQUAL(book_.reports.back().state, execution_report::placement);
+        BOOST_CHECK_EQUAL(book_.limits_.size(), 101);
+        BOOST_CHECK(book_.valid_limits.contains(create_bid(1.50).limit));
+        BOOST_CHECK(book_.valid_limits.contains(create_ask(2.30).limit));
+        BOOST_CHECK_EQUAL(book_.bid().value(), create_bid(1.50).limit);
+        BOOST_CHECK_EQUAL(book_.ask().value(), create_ask(2.30).limit);
+
+        // the window grows when the resting orders do not fit
+        book_.insert(create_ask(4.00, 100));
+        BOOST_CHECK_EQUAL(book_.reports.back().state, execution_report::placement);
+        BOOST_CHECK(book_.valid_limits.contains(create_bid(1.50).limit));
+        BOOST_CHECK(book_.valid_limits.contains(create_ask(4.00).limit));
+        BOOST_CHECK_EQUAL(book_.limits_.size(), 501);
+        BOOST_CHECK_EQUAL(book_.orders().size(), 3);
+
+        // or is refused beyond the maximum
+        book_.recentring.maximum_levels = 1000;
+        book_.insert(create_ask(20.00, 100));
+        BOOST_CHECK_EQUAL(book_.reports.back().state, execution_report::invalid);
+        BOOST_CHECK_EQUAL(book_.orders().size(), 3);
+    }
+
+    BOOST_AUTO_TEST_CASE(statically_allocated_book_recentre_near_zero)
+    {
+        auto  min_ = quote(price::approximate(1.00, currencies::USD), 100 *  currencies::USD.denominator);
+        auto  max_ = quote(price::approximate(2.00, currencies::USD), 100 *  currencies::USD.denominator);
+        auto book_ = markets::order_book::basic_static_order_book<tick_price_codec>(min_, max_);
+        book_.recentring.enabled = true;
+
+        // centring the bid would put the lower limit below zero
+        book_.insert(create_bid(0.10, 100));
+        BOOST_CHECK_EQUAL(book_.reports.back().state, execution_report::placement);
+        BOOST_CHECK_EQUAL(book_.valid_limits.lower, create_bid(0.00).limit);
+        BOOST_CHECK_EQUAL(book_.valid_limits.upper, create_bid(1.00).limit);
+        BOOST_CHECK_EQUAL(book_.limits_.size(), 101);
+
+        // growing keeps the lower limit at zero, and the limits on the grid
+        book_.insert(create_ask(1.50, 100));
+        BOOST_CHECK_EQUAL(book_.reports.back().state, execution_report::placement);
+        BOOST_CHECK_EQUAL(book_.valid_limits.lower, create_bid(0.00).limit);
+        BOOST_CHECK_EQUAL(book_.valid_limits.upper, create_bid(2.80).limit);
+        BOOST_CHECK_EQUAL(book_.limits_.size(), 281);
+        BOOST_CHECK_EQUAL(book_.bid().value(), create_bid(0.10).limit);
+        BOOST_CHECK_EQUAL(book_.ask().value(), create_ask(1.50).limit);
+
+        // resting orders are matched at their own level
+        book_.insert(create_bid(1.50, 40));
+        BOOST_CHECK_EQUAL(book_.reports.back().state, execution_report::match);
+        BOOST_CHECK_EQUAL(book_.reports.back().limit, create_ask(1.50).limit);
+        BOOST_CHECK_EQUAL(book_.best_ask_->quantity, 60);
+
+        // an odd width is not truncated towards the resting orders
+        book_.recentring.growth = 1.5;
+        book_.insert(create_ask(5.01, 100));
+        BOOST_CHECK_EQUAL(book_.reports.back().state, execution_report::placement);
+        BOOST_CHECK(book_.valid_limits.contains(create_bid(0.10).limit));
+        BOOST_CHECK(book_.valid_limits.contains(create_ask(5.01).limit));
+        BOOST_CHECK_EQUAL(book_.orders().size(), 3);
+    }
+
+    BOOST_AUTO_TEST_CASE(statically_allocated_book_owners)
+    {
+        BOOST_CHECK_LE(sizeof(static_order_book::record), 32);
+
+        auto  min_ = quote(price::approximate(1.00, currencies::USD), 100 *  currencies::USD.denominator);
+        auto  max_ = quote(price::approximate(2.00, currencies::USD), 100 *  currencies::USD.denominator);
+        auto book_ = markets::order_book::basic_static_order_book<tick_price_codec>(min_, max_);
+
+        std::vector<identity<agent>> owners_ = {identity<agent>({1}), identity<agent>({2}), identity<agent>({3})};
+        for(size_t i = 0; i < owners_.size(); ++i){
+            auto order_ = create_ask(1.50 + 0.01 * i, 100);
+            order_.owner = owners_[i];
+            book_.insert(order_);
+        }
+        auto second_ = create_ask(1.50, 100);
+        second_.owner = owners_[2];
+        book_.insert(second_);
+        BOOST_CHECK_EQUAL(book_.owners_.size(), 3);
+        book_.reports.clear();
+
+        // each resting order reports its own owner
+        book_.insert(create_bid(1.51, 250));
+        BOOST_REQUIRE_EQUAL(book_.reports.size(), 6);
+        BOOST_CHECK_EQUAL(book_.reports[1].owner, owners_[0]);
+        BOOST_CHECK_EQUAL(book_.reports[3].owner, owners_[2]);
+        BOOST_CHECK_EQUAL(book_.reports[5].owner, owners_[1]);
+        BOOST_CHECK_EQUAL(book_.reports[5].quantity, 50);
+
+        book_.reports.clear();
+        book_.cancel(book_.orders().front());
+        BOOST_CHECK_EQUAL(book_.reports.back().owner, owners_[1]);
+        BOOST_CHECK_EQUAL(book_.reports.back().quantity, 50);
+        BOOST_CHECK_EQUAL(book_.reports.back().limit, create_ask(1.51).limit);
+    }
+
+    BOOST_AUTO_TEST_CASE(binary_tree_book_price_time_priority)
+    {
+        binary_tree_order_book book_;
+
+        std::vector<identity<agent>> owners_ = {identity<agent>({1}), identity<agent>({2}), identity<agent>({3})};
+        auto ask_ = [&](double p, size_t q, size_t owner){
+            auto order_ = create_ask(p, q);
+            order_.owner = owners_[owner];
+            return order_;
+        };
+
+        book_.insert(ask_(1.02, 100, 0));
+        book_.insert(ask_(1.01, 100, 1));
+        book_.insert(ask_(1.01, 100, 2));
+        book_.insert(ask_(1.01, 100, 0));
+        BOOST_CHECK_EQUAL(book_.asks.size(), 2);
+        BOOST_CHECK_EQUAL(book_.asks.begin()->second.quantity, 300);
+        BOOST_CHECK_EQUAL(book_.asks.begin()->second.orders, 3);
+        BOOST_CHECK_EQUAL(book_.ask().value(), create_ask(1.01).limit);
+
+        // cancel the middle order of the queue, then a stale identifier
+        book_.cancel(2);
+        BOOST_CHECK_EQUAL(book_.reports.back().state, execution_report::cancel);
+        BOOST_CHECK_EQUAL(book_.reports.back().owner, owners_[2]);
+        book_.reports.clear();
+        book_.cancel(2);
+        BOOST_CHECK(book_.reports.empty());
+        BOOST_CHECK_EQUAL(book_.orders(), (std::vector<basic_book::order_identifier>{0, 1, 3}));
+
+        // matches the queue at 1.01 in time priority, then 1.02
+        book_.insert(create_bid(1.02, 250));
+        BOOST_REQUIRE_EQUAL(book_.reports.size(), 6);
+        BOOST_CHECK_EQUAL(book_.reports[1].identifier, 1);
+        BOOST_CHECK_EQUAL(book_.reports[3].identifier, 3);
+        BOOST_CHECK_EQUAL(book_.reports[5].identifier, 0);
+        BOOST_CHECK_EQUAL(book_.reports[5].quantity, 50);
+        BOOST_CHECK_EQUAL(book_.reports[5].limit, create_ask(1.02).limit);
+        BOOST_CHECK_EQUAL(book_.reports[5].owner, owners_[0]);
+        BOOST_CHECK_EQUAL(book_.asks.size(), 1);
+        BOOST_CHECK_EQUAL(book_.ask().value(), create_ask(1.02).limit);
+        BOOST_CHECK(!book_.bid().has_value());
+
+        // the remainder of an aggressor is placed
+        book_.reports.clear();
+        book_.insert(create_bid(1.02, 100));
+        BOOST_CHECK_EQUAL(book_.reports.back().state, execution_report::placement);
+        BOOST_CHECK_EQUAL(book_.reports.back().quantity, 50);
+        BOOST_CHECK(!book_.ask().has_value());
+        BOOST_CHECK_EQUAL(book_.bid().value(), create_bid(1.02).limit);
+        book_.insert(create_bid(1.00, 100));
+        BOOST_CHECK_EQUAL(book_.bid().value(), create_bid(1.02).limit);
+        book_.insert(create_ask(0.50, 200));
+        BOOST_CHECK(!book_.bid().has_value());
+        BOOST_CHECK_EQUAL(book_.ask().value(), create_ask(0.50).limit);
+        BOOST_CHECK_EQUAL(book_.orders().size(), 1);
+    }
+
+    BOOST_AUTO_TEST_CASE(paged_book_wide_band)
+    {
+        auto  min_ = quote(price::approximate(0.01, currencies::USD), 100 *  currencies::USD.denominator);
+        auto  max_ = quote(price::approximate(100000.00, currencies::USD), 100 *  currencies::USD.denominator);
+        auto book_ = paged_order_book(min_, max_);
+
+        BOOST_CHECK_EQUAL(book_.directory_.size(), (10000000 + 511) / 512);
+        BOOST_CHECK_EQUAL(book_.pages(), 0);
+
+        book_.insert(create_bid(1.00, 100));
+        book_.insert(create_bid(1.01, 100));
+        book_.insert(create_bid(50.00, 100));
+        book_.insert(create_ask(99999.99, 100));
+        book_.insert(create_ask(75000.00, 100));
+        BOOST_CHECK_EQUAL(book_.pages(), 4);
+        BOOST_CHECK_EQUAL(book_.bid().value(), create_bid(50.00).limit);
+        BOOST_CHECK_EQUAL(book_.ask().value(), create_ask(75000.00).limit);
+        BOOST_CHECK_EQUAL(book_.orders().size(), 5);
+
+        // sweep across pages, the emptied pages are released
+        book_.insert(create_ask(1.00, 250));
+        BOOST_CHECK_EQUAL(book_.bid().value(), create_bid(1.00).limit);
+        BOOST_CHECK_EQUAL(book_.at_(book_.best_bid_).quantity, 50);
+        BOOST_CHECK_EQUAL(book_.pages(), 3);
+        BOOST_CHECK_EQUAL(book_.spare_.size(), 1);
+
+        // the remaining order at 1.00 is cancelled, released pages are reused
+        book_.cancel(book_.orders().front());
+        BOOST_CHECK(!book_.bid().has_value());
+        BOOST_CHECK_EQUAL(book_.pages(), 2);
+        book_.insert(create_bid(20000.00, 100));
+        BOOST_CHECK_EQUAL(book_.spare_.size(), 1);
+
+        book_.insert(create_bid(100000.00, 300));
+        BOOST_CHECK(!book_.ask().has_value());
+        BOOST_CHECK_EQUAL(book_.bid().value(), create_bid(100000.00).limit);
+        BOOST_CHECK_EQUAL(book_.at_(book_.best_bid_).quantity, 100);
+
+        // the lowest and highest price are valid
+        book_.insert(create_ask(0.01, 1000));
+        BOOST_CHECK(!book_.bid().has_value());
+        BOOST_CHECK_EQUAL(book_.ask().value(), min_);
+        BOOST_CHECK_EQUAL(book_.orders().size(), 1);
+    }
+
+    BOOST_AUTO_TEST_CASE(paged_book_matching_engine)
+    {
+        auto  min_ = quote(price::approximate(0.01, currencies::USD), 100 *  currencies::USD.denominator);
+        auto  max_ = quote(price::approximate(1000.00, currencies::USD), 100 *  currencies::USD.denominator);
+        matching_engine engine_([&](){ return std::make_shared<paged_order_book>(min_, max_); });
+
+        engine_.insert(create_bid(10.00, 100));
+        engine_.insert(create_ask(10.00, 40));
+        auto &book_ = *engine_.books.begin()->second;
+        BOOST_CHECK_EQUAL(book_.reports.back().state, execution_report::match);
+        BOOST_CHECK_EQUAL(book_.bid().value(), create_bid(10.00).limit);
+        engine_.cancel(engine_.books.begin()->first, book_.orders().front());
+        BOOST_CHECK(!book_.bid().has_value());
+    }
+
+    BOOST_AUTO_TEST_CASE(book_depth)
+    {
+        auto  min_ = quote(price::approximate(0.01, currencies::USD), 100 *  currencies::USD.denominator);
+        auto  max_ = quote(price::approximate(10.00, currencies::USD), 100 *  currencies::USD.denominator);
+
+        std::vector<std::shared_ptr<basic_book>> books_ =
+            { std::make_shared<static_order_book>(min_, max_)
+            , std::make_shared<basic_static_order_book<tick_price_codec>>(min_, max_)
+            , std::make_shared<paged_order_book>(min_, max_)
+            , std::make_shared<binary_tree_order_book>()
+            };
+
+        for(auto &book_: books_){
+            BOOST_CHECK(book_->depth(limit_order::buy, 10).empty());
+
+            book_->insert(create_bid(4.00, 100));
+            book_->insert(create_bid(4.00, 200));
+            book_->insert(create_bid(3.50, 50));
+            book_->insert(create_bid(1.00, 10));
+            const auto cancelled_ = book_->reports.back().identifier;
+            book_->insert(create_ask(5.00, 100));
+            book_->insert(create_ask(7.25, 300));
+            book_->insert(create_ask(7.25, 300));
+
+            auto bids_ = book_->depth(limit_order::buy, 2);
+            BOOST_REQUIRE_EQUAL(bids_.size(), 2);
+            BOOST_CHECK_EQUAL(bids_[0].limit, create_bid(4.00).limit);
+            BOOST_CHECK_EQUAL(bids_[0].quantity, 300);
+            BOOST_CHECK_EQUAL(bids_[0].orders, 2);
+            BOOST_CHECK_EQUAL(bids_[1].limit, create_bid(3.50).limit);
+            BOOST_CHECK_EQUAL(bids_[1].quantity, 50);
+
+            auto asks_ = book_->depth(limit_order::sell, 10);
+            BOOST_REQUIRE_EQUAL(asks_.size(), 2);
+            BOOST_CHECK_EQUAL(asks_[0].limit, create_ask(5.00).limit);
+            BOOST_CHECK_EQUAL(asks_[1].quantity, 600);
+            BOOST_CHECK_EQUAL(asks_[1].orders, 2);
+
+            // partial match and cancellation update the aggregates
+            book_->insert(create_ask(4.00, 120));
+            book_->cancel(cancelled_);
+            bids_ = book_->depth(limit_order::buy, 10);
+            BOOST_REQUIRE_EQUAL(bids_.size(), 2);
+            BOOST_CHECK_EQUAL(bids_[0].quantity, 180);
+            BOOST_CHECK_EQUAL(bids_[0].orders, 1);
+            BOOST_CHECK_EQUAL(bids_[1].limit, create_bid(3.50).limit);
+
+            book_->insert(create_bid(7.25, 750));
+            asks_ = book_->depth(limit_order::sell, 10);
+            BOOST_REQUIRE_EQUAL(asks_.size(), 0);
+            bids_ = book_->depth(limit_order::buy, 1);
+            BOOST_REQUIRE_EQUAL(bids_.size(), 1);
+            BOOST_CHECK_EQUAL(bids_[0].limit, create_bid(7.25).limit);
+            BOOST_CHECK_EQUAL(bids_[0].quantity, 50);
+            BOOST_CHECK_EQUAL(bids_[0].orders, 1);
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE(batch_insert_cancel)
+    {
+        auto  min_ = quote(price::approximate(0.01, currencies::USD), 100 *  currencies::USD.denominator);
+        auto  max_ = quote(price::approximate(10.00, currencies::USD), 100 *  currencies::USD.denominator);
+
+        ticker first_(identity<law::property>({1}), identity<law::property>({0}));
+        ticker second_(identity<law::property>({2}), identity<law::property>({0}));
+
+        std::vector<limit_order> orders_;
+        for(size_t i = 0; i < 20; ++i){
+            auto order_ = (i % 2) ? create_ask(5.00 - 0.05 * (i % 7), 10 + i) : create_bid(4.80 + 0.05 * (i % 5), 10 + i);
+            order_.symbol = (i % 3) ? first_ : second_;
+            orders_.push_back(order_);
+        }
+
+        // a batch gives the same reports as inserting the orders one by one
+        matching_engine sequential_([&](){ return std::make_shared<static_order_book>(min_, max_); });
+        matching_engine batched_([&](){ return std::make_shared<static_order_book>(min_, max_); });
+        for(const auto &o: orders_){
+            sequential_.insert(o);
+        }
+        batched_.insert(orders_);
+
+        for(const auto &t: {first_, second_}){
+            const auto &expected_ = sequential_.books[t]->reports;
+            const auto &reports_ = batched_.books[t]->reports;
+            BOOST_REQUIRE_EQUAL(reports_.size(), expected_.size());
+            for(size_t i = 0; i < reports_.size(); ++i){
+                BOOST_CHECK_EQUAL(reports_[i].state, expected_[i].state);
+                BOOST_CHECK_EQUAL(reports_[i].identifier, expected_[i].identifier);
+                BOOST_CHECK_EQUAL(reports_[i].quantity, expected_[i].quantity);
+                BOOST_CHECK_EQUAL(reports_[i].limit, expected_[i].limit);
+            }
+        }
+
+        auto &book_ = *batched_.books[first_];
+        const auto open_ = book_.orders();
+        BOOST_REQUIRE(!open_.empty());
+        book_.reports.clear();
+        batched_.cancel(first_, open_);
+        BOOST_CHECK_EQUAL(book_.reports.size(), open_.size());
+        BOOST_CHECK(book_.orders().empty());
+        BOOST_CHECK(!book_.bid().has_value());
+        BOOST_CHECK(!book_.ask().has_value());
+
+        binary_tree_order_book tree_;
+        tree_.insert(std::vector<limit_order>{create_bid(1.00, 10), create_ask(0.50, 4)});
+        BOOST_CHECK_EQUAL(tree_.depth(limit_order::buy, 1)[0].quantity, 6);
+
+        // interleaved symbols are grouped, so each book receives one batch
+        struct counting_book
+        : public binary_tree_order_book
+        {
+            size_t batches = 0;
+
+            using binary_tree_order_book::insert;
+
+            void insert(const limit_order *first, const limit_order *last) override
+            {
+                ++batches;
+                binary_tree_order_book::insert(first, last);
+            }
+        };
+        matching_engine grouped_([](){ return std::make_shared<counting_book>(); });
+        grouped_.insert(orders_);
+        for(const auto &t: {first_, second_}){
+            BOOST_CHECK_EQUAL(std::static_pointer_cast<counting_book>(grouped_.books[t])->batches, 1);
+            BOOST_CHECK_EQUAL(grouped_.books[t]->orders().size(), sequential_.books[t]->orders().size());
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE(report_sinks)
+    {
+        auto  min_ = quote(price::approximate(0.01, currencies::USD), 100 *  currencies::USD.denominator);
+        auto  max_ = quote(price::approximate(10.00, currencies::USD), 100 *  currencies::USD.denominator);
+        auto book_ = paged_order_book(min_, max_);
+
+        auto counting_ = std::make_shared<counting_report_sink>();
+        book_.sink = counting_;
+        book_.insert(create_bid(1.00, 100));
+        book_.insert(create_bid(1.01, 100));
+        book_.insert(create_ask(1.00, 150));
+        BOOST_CHECK(book_.reports.empty());
+        BOOST_CHECK_EQUAL(counting_->reports[execution_report::placement], 2);
+        BOOST_CHECK_EQUAL(counting_->reports[execution_report::match], 4);
+        BOOST_CHECK_EQUAL(counting_->matched, 300);
+
+        std::vector<execution_report> received_;
+        book_.sink = std::make_shared<callback_report_sink>([&](const execution_report &r){ received_.push_back(r); });
+        book_.cancel(book_.orders().front());
+        BOOST_REQUIRE_EQUAL(received_.size(), 1);
+        BOOST_CHECK_EQUAL(received_[0].state, execution_report::cancel);
+        BOOST_CHECK_EQUAL(received_[0].quantity, 50);
+        BOOST_CHECK_EQUAL(received_[0].limit, create_bid(1.00).limit);
+
+        auto ring_ = std::make_shared<ring_buffer_report_sink>(3);
+        book_.sink = ring_;
+        for(size_t i = 0; i < 5; ++i){
+            book_.insert(create_ask(2.00, 1 + i));
+        }
+        BOOST_CHECK_EQUAL(ring_->size(), 3);
+        BOOST_CHECK_EQUAL(ring_->overwritten, 2);
+        BOOST_CHECK_EQUAL((*ring_)[0].quantity, 3);
+        BOOST_CHECK_EQUAL((*ring_)[2].quantity, 5);
+        ring_->clear();
+        BOOST_CHECK(ring_->empty());
+
+        // without a sink, reports are collected as before
+        book_.sink.reset();
+        book_.insert(create_bid(2.00, 1));
+        BOOST_CHECK_EQUAL(book_.reports.size(), 2);
+    }
+
+    BOOST_AUTO_TEST_CASE(sharded_matching_engine_order)
+    {
+        std::vector<ticker> symbols_;
+        for(std::uint64_t s = 0; s < 7; ++s){
+            symbols_.emplace_back(identity<law::property>({s}), identity<law::property>({0}));
+        }
+
+        std::vector<limit_order> orders_;
+        for(size_t i = 0; i < 2000; ++i){
+            auto order_ = (i % 2) ? create_ask(5.00 - 0.05 * (i % 7), 10 + i % 13) : create_bid(4.80 + 0.05 * (i % 5), 10 + i % 11);
+            order_.symbol = symbols_[(i * 5) % symbols_.size()];
+            orders_.push_back(order_);
+        }
+
+        // the reports of each order, in order, when matched on one thread
+        matching_engine sequential_;
+        std::vector<std::pair<ticker, execution_report>> expected_;
+        for(const auto &o: orders_){
+            sequential_.insert(o);
+            for(const auto &r: sequential_.books[o.symbol]->reports){
+                expected_.emplace_back(o.symbol, r);
+            }
+            sequential_.books[o.symbol]->reports.clear();
+        }
+
+        sharded_matching_engine sharded_(3, [](){ return std::make_shared<binary_tree_order_book>(); }, 64);
+        BOOST_CHECK_EQUAL(sharded_.shards(), 3);
+        sharded_.insert(orders_);
+        sharded_.synchronize();
+
+        BOOST_REQUIRE_EQUAL(sharded_.reports.size(), expected_.size());
+        for(size_t i = 0; i < expected_.size(); ++i){
+            BOOST_CHECK(sharded_.reports[i].symbol == expected_[i].first);
+            BOOST_CHECK_EQUAL(sharded_.reports[i].report.state, expected_[i].second.state);
+            BOOST_CHECK_EQUAL(sharded_.reports[i].report.identifier, expected_[i].second.identifier);
+            BOOST_CHECK_EQUAL(sharded_.reports[i].report.quantity, expected_[i].second.quantity);
+        }
+        for(size_t i = 1; i < sharded_.reports.size(); ++i){
+            BOOST_CHECK_LE(sharded_.reports[i - 1].sequence, sharded_.reports[i].sequence);
+        }
+
+        for(const auto &s: symbols_){
+            auto book_ = sharded_.book(s);
+            BOOST_REQUIRE(book_);
+            auto open_ = book_->orders();
+            for(auto o: open_){
+                sharded_.cancel(s, o);
+            }
+            sharded_.synchronize();
+            BOOST_CHECK_EQUAL(sharded_.reports.size(), open_.size());
+            BOOST_CHECK(book_->orders().empty());
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE(call_auction_uniform_price)
+    {
+        for(auto allocation_: {call_auction::time_priority, call_auction::pro_rata}){
+            call_auction auction_(100);
+            auction_.insert(create_bid(1.05, 10));
+            const auto first_ = auction_.insert(create_bid(1.03, 20));
+            const auto second_ = auction_.insert(create_bid(1.03, 15));
+            auction_.insert(create_ask(1.00, 25));
+            auction_.insert(create_ask(1.03, 10));
+            auction_.insert(create_ask(1.06, 30));
+            BOOST_CHECK_EQUAL(first_, 101);
+
+            // 1.03 executes 35, more than any other price
+            auto result_ = auction_.clear(allocation_);
+            BOOST_REQUIRE(result_.price.has_value());
+            BOOST_CHECK_EQUAL(result_.price.value(), create_bid(1.03).limit);
+            BOOST_CHECK_EQUAL(result_.volume, 35);
+
+            std::map<basic_book::order_identifier, std::uint32_t> executed_;
+            std::uint64_t bought_ = 0;
+            std::uint64_t sold_ = 0;
+            for(const auto &e: result_.executions){
+                BOOST_CHECK_EQUAL(e.report.state, execution_report::match);
+                BOOST_CHECK_EQUAL(e.report.limit, result_.price.value());
+                executed_[e.report.identifier] = e.report.quantity;
+                (limit_order::buy == e.report.side ? bought_ : sold_) += e.report.quantity;
+            }
+            BOOST_CHECK_EQUAL(bought_, 35);
+            BOOST_CHECK_EQUAL(sold_, 35);
+
+            // the better limit executes in full, the rest of the demand
+            // is rationed at the clearing price
+            BOOST_CHECK_EQUAL(executed_[100], 10);
+            if(call_auction::time_priority == allocation_){
+                BOOST_CHECK_EQUAL(executed_[first_], 20);
+                BOOST_CHECK_EQUAL(executed_[second_], 5);
+            }else{
+                BOOST_CHECK_EQUAL(executed_[first_], 15);
+                BOOST_CHECK_EQUAL(executed_[second_], 10);
+            }
+
+            // pro rata leaves a remainder on both marginal bids
+            const std::size_t remaining_ = call_auction::time_priority == allocation_ ? 2 : 3;
+            BOOST_CHECK_EQUAL(auction_.orders.size(), remaining_);
+            BOOST_CHECK(!auction_.clear(allocation_).price.has_value());
+            auto cancelled_ = auction_.cancel(second_);
+            BOOST_REQUIRE(cancelled_.has_value());
+            BOOST_CHECK_EQUAL(cancelled_->report.state, execution_report::cancel);
+            BOOST_CHECK_EQUAL(cancelled_->report.identifier, second_);
+            BOOST_CHECK_EQUAL(cancelled_->report.quantity, cancelled_->order.quantity);
+            BOOST_CHECK(!auction_.cancel(second_));
+            BOOST_CHECK_EQUAL(auction_.size(), remaining_ - 1);
+            BOOST_CHECK_EQUAL(auction_.cancel_all().size(), remaining_ - 1);
+            BOOST_CHECK(auction_.orders.empty());
+        }
+    }
+
+    BOOST_AUTO_TEST_CASE(participant_registry_slots)
+    {
+        participant_registry registry_;
+        BOOST_CHECK_EQUAL(registry_.intern(identity<agent>{7}), 0);
+        BOOST_CHECK_EQUAL(registry_.intern(identity<agent>{3}), 1);
+        BOOST_CHECK_EQUAL(registry_.intern(identity<agent>{7}), 0);
+        BOOST_CHECK_EQUAL(registry_.size(), 2);
+        BOOST_CHECK(registry_[1] == identity<agent>{3});
+        BOOST_CHECK(!registry_.find(identity<agent>{5}).has_value());
+
+        BOOST_CHECK(!registry_.active(0));
+        registry_.activate(0);
+        BOOST_CHECK(registry_.active(0));
+        registry_.activate(0, false);
+        BOOST_CHECK(!registry_.active(0));
+        BOOST_CHECK(!registry_.active(2));
+
+        // slots are not reused
+        BOOST_CHECK_EQUAL(registry_.find(identity<agent>{7}).value(), 0);
+        BOOST_CHECK_EQUAL(registry_.intern(identity<agent>{5}), 2);
+    }
+
     limit_order create(double p, size_t q = 1000, limit_order::side_t side = limit_order::side_t::sell)
     {
         esl::economics::markets::ticker ticker_dummy_;
@@ -458,7 +1150,7 @@ public:
         o.limit    = quote(fundamental_estimate, USD.denominator );
 
         auto latency = network_model.sample(identifier, m, seed);
-        auto message = this->template create_message<new_order_single>
+        auto message = this->template create_message<new_order_single_message>
                 ( m
                   , step.lower + latency
                   );
@@ -571,7 +1263,7 @@ BOOST_AUTO_TEST_CASE(chiarella_iori_2002)
 
         t->markets.push_back( {(*exchange_), market_open_, market_close_, {ticker_}}  );
 
-        exchange_->positions[ticker_].emplace(t->identifier, position_);
+        exchange_->position(ticker_, t->identifier) = position_;
     }
 
     auto t1 = std::chrono::high_resolution_clock::now();
@@ -587,6 +1279,434 @@ BOOST_AUTO_TEST_CASE(chiarella_iori_2002)
     book_->display();
 }
 
+///
+/// \brief  An exchange with one symbol, to which messages are delivered
+///         one time point at a time, as the model would
+///
+struct exchange_fixture
+{
+    environment environment_;
+
+    model model_;
+
+    markets::ticker ticker_;
+
+    std::shared_ptr<centralized_exchange> exchange_;
+
+    std::seed_seq seed_;
+
+    exchange_fixture()
+    : model_(environment_, parametrization(0, 0, 1'000))
+    , ticker_({0, 1}, {0, 2})
+    , seed_({0})
+    {
+        exchange_ = model_.template create<centralized_exchange>(model_.world, std::vector<markets::ticker>{ticker_});
+        auto  min_ = quote(price::approximate(0.01, currencies::USD), 100 *  currencies::USD.denominator);
+        auto  max_ = quote(price::approximate(10.00, currencies::USD), 100 *  currencies::USD.denominator);
+        exchange_->books.emplace(ticker_, std::make_shared<static_order_book>(min_, max_));
+    }
+
+    void deliver(const std::shared_ptr<interaction::header> &m)
+    {
+        exchange_->inbox.emplace(m->received, m);
+    }
+
+    void order(const identity<agent> &sender, limit_order o, time_point t, const markets::ticker &symbol)
+    {
+        auto m = std::make_shared<new_order_single_message>(sender, exchange_->identifier, t, t);
+        o.symbol = symbol;
+        o.owner  = sender;
+        m->order_details = o;
+        deliver(m);
+    }
+
+    void order(const identity<agent> &sender, limit_order o, time_point t)
+    {
+        order(sender, std::move(o), t, ticker_);
+    }
+
+    void cancel(const identity<agent> &sender, basic_book::order_identifier identifier, time_point t, const markets::ticker &symbol)
+    {
+        auto m = std::make_shared<cancel_order_message>(sender, exchange_->identifier, t, t);
+        m->symbol = symbol;
+        m->order  = identifier;
+        deliver(m);
+    }
+
+    void cancel(const identity<agent> &sender, basic_book::order_identifier identifier, time_point t)
+    {
+        cancel(sender, identifier, t, ticker_);
+    }
+
+    void subscribe(const identity<agent> &sender, market_data_request_message::request_t type, time_point t, std::uint8_t depth = 0)
+    {
+        deliver(std::make_shared<market_data_request_message>(sender, exchange_->identifier, t, t, std::vector<markets::ticker>{ticker_}, type, depth));
+    }
+
+    ///
+    /// \brief  Handles the messages delivered at `t` and lets the exchange
+    ///         act, then takes the messages it sent
+    ///
+    /// \return the messages sent, and the next time the exchange acts
+    std::pair<std::vector<std::shared_ptr<interaction::header>>, time_point> step(time_point t)
+    {
+        time_interval step_(t, t + 1);
+        auto next_ = exchange_->process_messages(step_, seed_);
+        next_ = std::min(next_, exchange_->act(step_, seed_));
+        exchange_->inbox.consume(t);
+        std::vector<std::shared_ptr<interaction::header>> sent_(exchange_->outbox.begin(), exchange_->outbox.end());
+        exchange_->outbox.clear();
+        return {sent_, next_};
+    }
+
+    ///
+    /// \brief  The individual reports among `messages`
+    ///
+    static std::vector<std::shared_ptr<execution_report_message>> reports(const std::vector<std::shared_ptr<interaction::header>> &messages)
+    {
+        std::vector<std::shared_ptr<execution_report_message>> result_;
+        for(const auto &m: messages){
+            if(auto r = std::dynamic_pointer_cast<execution_report_message>(m)){
+                result_.push_back(r);
+            }
+        }
+        return result_;
+    }
+
+    ///
+    /// \brief  The market data among `messages`, by recipient
+    ///
+    static std::map<identity<agent>, std::shared_ptr<market_data_message>> market_data(const std::vector<std::shared_ptr<interaction::header>> &messages)
+    {
+        std::map<identity<agent>, std::shared_ptr<market_data_message>> result_;
+        for(const auto &m: messages){
+            if(auto d = std::dynamic_pointer_cast<market_data_message>(m)){
+                BOOST_CHECK(result_.emplace(d->recipient, d).second);
+            }
+        }
+        return result_;
+    }
+};
+
+BOOST_AUTO_TEST_CASE(exchange_market_data_snapshot)
+{
+    exchange_fixture f;
+    identity<agent> requester_({11}), seller_({12}), buyer_({13});
+
+    f.subscribe(requester_, market_data_request_message::snapshot, 1, 2);
+    auto data_ = exchange_fixture::market_data(f.step(1).first);
+    BOOST_REQUIRE_EQUAL(data_.size(), 1);
+    BOOST_CHECK(data_[requester_]->snapshot->ask.empty());
+    BOOST_CHECK(data_[requester_]->snapshot->trades.empty());
+
+    // a snapshot is sent once, later trades are neither sent nor kept
+    f.order(seller_, create_ask(1.00, 10), 2);
+    BOOST_CHECK(exchange_fixture::market_data(f.step(2).first).empty());
+    f.order(buyer_, create_bid(1.00, 3), 3);
+    BOOST_CHECK(exchange_fixture::market_data(f.step(3).first).empty());
+    BOOST_CHECK(f.exchange_->market_data_subscriptions[f.ticker_].empty());
+    BOOST_CHECK(f.exchange_->pending_market_data.empty());
+
+    // a new request sees the book, but not the earlier trades
+    f.subscribe(requester_, market_data_request_message::snapshot, 4, 2);
+    data_ = exchange_fixture::market_data(f.step(4).first);
+    BOOST_REQUIRE_EQUAL(data_.size(), 1);
+    BOOST_REQUIRE_EQUAL(data_[requester_]->snapshot->ask.size(), 1);
+    BOOST_CHECK_EQUAL(data_[requester_]->snapshot->ask[0].second, 7);
+    BOOST_CHECK(data_[requester_]->snapshot->trades.empty());
+    BOOST_CHECK(f.exchange_->pending_market_data.empty());
+}
+
+BOOST_AUTO_TEST_CASE(exchange_market_data_conflation)
+{
+    exchange_fixture f;
+    identity<agent> fast_({11}), other_({12}), slow_({13}), seller_({14}), buyer_({15});
+
+    f.subscribe(fast_, market_data_request_message::stream, 1);
+    f.subscribe(other_, market_data_request_message::stream, 1);
+    f.subscribe(slow_, market_data_request_message::stream, 1);
+    f.step(1);
+    auto &subscriptions_ = f.exchange_->market_data_subscriptions[f.ticker_];
+    // as if the initial image had been sent with a period of 10
+    auto &slow_subscription_ = subscriptions_[f.exchange_->registry.find(slow_).value()];
+    slow_subscription_.periodicity = 10;
+    slow_subscription_.start = 11;
+
+    f.order(seller_, create_ask(1.00, 10), 2);
+    auto data_ = exchange_fixture::market_data(f.step(2).first);
+    BOOST_CHECK_EQUAL(data_.size(), 2);
+    BOOST_CHECK_EQUAL(data_.count(slow_), 0);
+
+    // fast subscribers get one update per time point, with all its trades,
+    // and subscribers at the same depth share it
+    f.order(buyer_, create_bid(1.00, 3), 3);
+    f.step(3);
+    f.order(buyer_, create_bid(1.00, 2), 4);
+    f.order(buyer_, create_bid(1.00, 1), 4);
+    data_ = exchange_fixture::market_data(f.step(4).first);
+    BOOST_REQUIRE_EQUAL(data_.size(), 2);
+    BOOST_CHECK_EQUAL(data_[fast_]->snapshot, data_[other_]->snapshot);
+    BOOST_REQUIRE_EQUAL(data_[fast_]->snapshot->trades.size(), 2);
+    BOOST_CHECK_EQUAL(data_[fast_]->snapshot->trades[0].second + data_[fast_]->snapshot->trades[1].second, 3);
+    BOOST_CHECK_EQUAL(data_[fast_]->snapshot->ask[0].second, 4);
+
+    // the trades are kept for the slow subscriber only
+    BOOST_CHECK_EQUAL(f.exchange_->pending_market_data[f.ticker_].trades.size(), 3);
+
+    // which receives them all once its period has passed
+    for(time_point t = 5; t < 11; ++t){
+        BOOST_CHECK(exchange_fixture::market_data(f.step(t).first).empty());
+    }
+    data_ = exchange_fixture::market_data(f.step(11).first);
+    BOOST_REQUIRE_EQUAL(data_.size(), 1);
+    BOOST_REQUIRE_EQUAL(data_[slow_]->snapshot->trades.size(), 3);
+    std::size_t traded_ = 0;
+    for(const auto &[limit_, quantity_]: data_[slow_]->snapshot->trades){
+        BOOST_CHECK_EQUAL(limit_, create_ask(1.00).limit);
+        traded_ += quantity_;
+    }
+    BOOST_CHECK_EQUAL(traded_, 6);
+    BOOST_CHECK(f.exchange_->pending_market_data.empty());
+
+    // the trades after the reset are numbered from the start again
+    f.order(buyer_, create_bid(1.00, 4), 12);
+    data_ = exchange_fixture::market_data(f.step(12).first);
+    BOOST_REQUIRE_EQUAL(data_.size(), 2);
+    BOOST_REQUIRE_EQUAL(data_[fast_]->snapshot->trades.size(), 1);
+    BOOST_CHECK_EQUAL(data_[fast_]->snapshot->trades[0].second, 4);
+    data_ = exchange_fixture::market_data(f.step(21).first);
+    BOOST_REQUIRE_EQUAL(data_.size(), 1);
+    BOOST_REQUIRE_EQUAL(data_[slow_]->snapshot->trades.size(), 1);
+    BOOST_CHECK_EQUAL(data_[slow_]->snapshot->trades[0].second, 4);
+    BOOST_CHECK(f.exchange_->pending_market_data.empty());
+}
+
+BOOST_AUTO_TEST_CASE(exchange_report_delivery)
+{
+    for(auto delivery_: {centralized_exchange::report_delivery_t::batched, centralized_exchange::report_delivery_t::summarized}){
+        const bool summarized_ = centralized_exchange::report_delivery_t::summarized == delivery_;
+        exchange_fixture f;
+        f.exchange_->report_delivery = delivery_;
+        identity<agent> seller_({11}), buyer_({12});
+
+        // the batches sent in a time point, by recipient
+        auto batches_ = [](const std::vector<std::shared_ptr<interaction::header>> &messages){
+            std::map<identity<agent>, std::shared_ptr<execution_report_batch_message>> result_;
+            for(const auto &m: messages){
+                BOOST_CHECK(!std::dynamic_pointer_cast<execution_report_message>(m));
+                if(auto b = std::dynamic_pointer_cast<execution_report_batch_message>(m)){
+                    BOOST_CHECK(result_.emplace(b->recipient, b).second);
+                }
+            }
+            return result_;
+        };
+
+        f.order(seller_, create_ask(1.00, 5), 1);
+        f.order(seller_, create_ask(1.00, 5), 1);
+        auto placed_ = batches_(f.step(1).first);
+        BOOST_REQUIRE_EQUAL(placed_.size(), 1);
+        BOOST_REQUIRE_EQUAL(placed_[seller_]->reports.size(), 2);
+        BOOST_CHECK_EQUAL(placed_[seller_]->symbols.size(), 1);
+        for(const auto &e: placed_[seller_]->reports){
+            BOOST_CHECK_EQUAL(e.report.state, execution_report::placement);
+        }
+
+        // the bid executes against both asks at one price
+        f.order(buyer_, create_bid(1.00, 10), 2);
+        auto matched_ = batches_(f.step(2).first);
+        BOOST_REQUIRE_EQUAL(matched_.size(), 2);
+        BOOST_CHECK_EQUAL(matched_[buyer_]->sent, 2);
+
+        std::uint64_t bought_ = 0;
+        for(const auto &e: matched_[buyer_]->reports){
+            BOOST_CHECK_EQUAL(e.report.state, execution_report::match);
+            bought_ += e.report.quantity;
+        }
+        BOOST_CHECK_EQUAL(bought_, 10);
+        // the fills of the bid are merged, the asks are different orders
+        BOOST_CHECK_EQUAL(matched_[buyer_]->reports.size(), summarized_ ? 1 : 2);
+        BOOST_REQUIRE_EQUAL(matched_[seller_]->reports.size(), 2);
+        BOOST_CHECK_NE(matched_[seller_]->reports[0].report.identifier, matched_[seller_]->reports[1].report.identifier);
+
+        // a new time point starts new batches
+        f.order(seller_, create_ask(1.10, 1), 3);
+        auto next_ = batches_(f.step(3).first);
+        BOOST_REQUIRE_EQUAL(next_.size(), 1);
+        BOOST_CHECK_NE(next_[seller_], placed_[seller_]);
+        BOOST_CHECK_EQUAL(next_[seller_]->reports.size(), 1);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(exchange_parallel_books)
+{
+    // the messages sent by an exchange with the given number of workers,
+    // for the same orders and cancellations on several books
+    auto run_ = [](unsigned int workers){
+        exchange_fixture f;
+        f.exchange_->book_workers = workers;
+        std::vector<markets::ticker> symbols_ = {f.ticker_};
+        for(std::uint64_t k = 3; k < 6; ++k){
+            symbols_.emplace_back(identity<law::property>({0, k}), identity<law::property>({0, 2}));
+            auto  min_ = quote(price::approximate(0.01, currencies::USD), 100 *  currencies::USD.denominator);
+            auto  max_ = quote(price::approximate(10.00, currencies::USD), 100 *  currencies::USD.denominator);
+            f.exchange_->books.emplace(symbols_.back(), std::make_shared<static_order_book>(min_, max_));
+        }
+
+        std::mt19937 generator_(7);
+        std::vector<std::pair<markets::ticker, basic_book::order_identifier>> placed_;
+        std::vector<std::string> sent_;
+        for(time_point t = 1; t < 40; ++t){
+            for(unsigned int n = 0; n < 12; ++n){
+                identity<agent> sender_({100 + generator_() % 5});
+                const auto &symbol_ = symbols_[generator_() % symbols_.size()];
+                if(0 == generator_() % 4 && !placed_.empty()){
+                    const auto &[cancelled_symbol_, identifier_] = placed_[generator_() % placed_.size()];
+                    f.cancel(sender_, identifier_, t, cancelled_symbol_);
+                    continue;
+                }
+                auto limit_ = 1.00 + 0.01 * double(generator_() % 20);
+                auto quantity_ = 1 + generator_() % 50;
+                f.order(sender_, generator_() % 2 ? create_bid(limit_, quantity_) : create_ask(limit_, quantity_), t, symbol_);
+            }
+            for(const auto &m: f.step(t).first){
+                auto r = std::dynamic_pointer_cast<execution_report_message>(m);
+                BOOST_REQUIRE(r);
+                if(execution_report::placement == r->report.state){
+                    placed_.emplace_back(r->order.symbol, r->report.identifier);
+                }
+                std::stringstream description_;
+                description_ << r->recipient << " " << r->order.symbol << " " << int(r->report.state)
+                             << " " << r->report.identifier << " " << r->report.quantity << " " << r->report.limit;
+                sent_.push_back(description_.str());
+            }
+        }
+        return sent_;
+    };
+
+    const auto serial_ = run_(1);
+    BOOST_CHECK_LT(100, serial_.size());
+    const auto parallel_ = run_(4);
+    BOOST_CHECK(serial_ == parallel_);
+
+    // an exception while matching reaches the caller of act()
+    struct failing_book
+    : public binary_tree_order_book
+    {
+        using binary_tree_order_book::insert;
+
+        void insert(const limit_order &order) override
+        {
+            (void)order;
+            throw esl::exception("failing book");
+        }
+    };
+    exchange_fixture f;
+    f.exchange_->book_workers = 4;
+    markets::ticker failing_({0, 3}, {0, 2});
+    f.exchange_->books.emplace(failing_, std::make_shared<failing_book>());
+    f.order(identity<agent>({11}), create_bid(1.00, 1), 1);
+    f.order(identity<agent>({11}), create_bid(1.00, 1), 1, failing_);
+    BOOST_CHECK_THROW(f.step(1), esl::exception);
+}
+
+BOOST_AUTO_TEST_CASE(exchange_batch_auction_session)
+{
+    exchange_fixture f;
+    centralized_exchange::session session_;
+    session_.open     = time_interval(0, 100);
+    session_.type     = centralized_exchange::session::session_t::batch_auction;
+    session_.interval = 10;
+    f.exchange_->sessions.push_back(session_);
+
+    identity<agent> first_({11}), second_({12}), third_({13});
+
+    // orders are acknowledged, and not matched until the clearing
+    f.order(first_, create_bid(1.05, 10), 1);
+    auto [placed_, next_] = f.step(1);
+    auto reports_ = exchange_fixture::reports(placed_);
+    BOOST_REQUIRE_EQUAL(reports_.size(), 1);
+    BOOST_CHECK_EQUAL(reports_[0]->recipient, first_);
+    BOOST_CHECK_EQUAL(reports_[0]->report.state, execution_report::placement);
+    BOOST_CHECK_LE(centralized_exchange::auction_identifiers, reports_[0]->report.identifier);
+    BOOST_CHECK_EQUAL(next_, 2);
+    const auto first_order_ = reports_[0]->report.identifier;
+
+    f.order(second_, create_ask(1.00, 4), 2);
+    BOOST_CHECK_EQUAL(exchange_fixture::reports(f.step(2).first).size(), 1);
+    f.order(third_, create_bid(1.00, 5), 3);
+    BOOST_CHECK_EQUAL(exchange_fixture::reports(f.step(3).first).size(), 1);
+    BOOST_CHECK_EQUAL(f.exchange_->auctions.at(f.ticker_).clearing, 10);
+    BOOST_CHECK(exchange_fixture::reports(f.step(9).first).empty());
+
+    // the first clearing executes the ask against the best bid
+    auto cleared_ = exchange_fixture::reports(f.step(10).first);
+    BOOST_REQUIRE_EQUAL(cleared_.size(), 2);
+    for(const auto &r: cleared_){
+        BOOST_CHECK_EQUAL(r->report.state, execution_report::match);
+        BOOST_CHECK_EQUAL(r->report.quantity, 4);
+        BOOST_CHECK_EQUAL(r->report.limit, create_bid(1.05).limit);
+    }
+    BOOST_CHECK_EQUAL(f.exchange_->auctions.at(f.ticker_).clearing, 20);
+
+    // the remainder of the first order is cancelled, and reported
+    f.cancel(first_, first_order_, 12);
+    auto [cancelled_, after_cancel_] = f.step(12);
+    auto cancel_reports_ = exchange_fixture::reports(cancelled_);
+    BOOST_REQUIRE_EQUAL(cancel_reports_.size(), 1);
+    BOOST_CHECK_EQUAL(cancel_reports_[0]->recipient, first_);
+    BOOST_CHECK_EQUAL(cancel_reports_[0]->report.state, execution_report::cancel);
+    BOOST_CHECK_EQUAL(cancel_reports_[0]->report.identifier, first_order_);
+    BOOST_CHECK_EQUAL(cancel_reports_[0]->report.quantity, 6);
+    BOOST_CHECK_EQUAL(after_cancel_, 13);
+    BOOST_CHECK_EQUAL(f.exchange_->auctions.at(f.ticker_).book.size(), 1);
+
+    // a second cancellation of the same order has no effect
+    f.cancel(first_, first_order_, 13);
+    BOOST_CHECK(exchange_fixture::reports(f.step(13).first).empty());
+
+    // nothing executes in the remaining clearings, and the last order is
+    // cancelled when the session closes
+    BOOST_CHECK(exchange_fixture::reports(f.step(20).first).empty());
+    auto closed_ = exchange_fixture::reports(f.step(100).first);
+    BOOST_REQUIRE_EQUAL(closed_.size(), 1);
+    BOOST_CHECK_EQUAL(closed_[0]->recipient, third_);
+    BOOST_CHECK_EQUAL(closed_[0]->report.state, execution_report::cancel);
+    BOOST_CHECK_EQUAL(closed_[0]->report.quantity, 5);
+    BOOST_CHECK(f.exchange_->auctions.at(f.ticker_).book.empty());
+    BOOST_CHECK_EQUAL(f.exchange_->auctions.at(f.ticker_).clearing, std::numeric_limits<time_point>::max());
+}
+
+BOOST_AUTO_TEST_CASE(exchange_auction_direct_cancel)
+{
+    exchange_fixture f;
+    centralized_exchange::session session_;
+    session_.open     = time_interval(0, 100);
+    session_.type     = centralized_exchange::session::session_t::batch_auction;
+    session_.interval = 10;
+    f.exchange_->sessions.push_back(session_);
+
+    identity<agent> owner_({11});
+    f.order(owner_, create_bid(1.05, 10), 1);
+    auto placed_ = exchange_fixture::reports(f.step(1).first);
+    BOOST_REQUIRE_EQUAL(placed_.size(), 1);
+    const auto identifier_ = placed_[0]->report.identifier;
+
+    // cancelling through the exchange's interface reports to the owner
+    // when the exchange next acts
+    f.exchange_->cancel(f.ticker_, identifier_);
+    BOOST_CHECK(f.exchange_->auctions.at(f.ticker_).book.empty());
+    auto cancelled_ = exchange_fixture::reports(f.step(2).first);
+    BOOST_REQUIRE_EQUAL(cancelled_.size(), 1);
+    BOOST_CHECK_EQUAL(cancelled_[0]->recipient, owner_);
+    BOOST_CHECK_EQUAL(cancelled_[0]->report.state, execution_report::cancel);
+    BOOST_CHECK_EQUAL(cancelled_[0]->report.identifier, identifier_);
+    BOOST_CHECK_EQUAL(cancelled_[0]->report.quantity, 10);
+
+    // and only once
+    f.exchange_->cancel(f.ticker_, identifier_);
+    BOOST_CHECK(exchange_fixture::reports(f.step(3).first).empty());
+}
+
 
 
 BOOST_AUTO_TEST_SUITE_END()  // ESL
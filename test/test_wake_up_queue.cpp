@@ -0,0 +1,132 @@
+/// \file   test_wake_up_queue.cpp
+///
+/// \brief
+///
+/// \authors    Maarten P. Scholl
+/// \date       2026-10-17
+/// \copyright  Copyright 2017-2026 The Institute for New Economic Thinking,
+///             Oxford Martin School, University of Oxford
+///
+///             Licensed under the Apache License, Version 2.0 (the "License");
+///             you may not use this file except in compliance with the License.
+///             You may obtain a copy of the License at
+///
+///                 http://www.apache.org/licenses/LICENSE-2.0
+///
+///             Unless required by applicable law or agreed to in writing,
+///             software distributed under the License is distributed on an "AS
+///             IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+///             express or implied. See the License for the specific language
+///             governing permissions and limitations under the License.
+///
+///             You may obtain instructions to fulfill the attribution
+///             requirements in CITATION.cff
+///
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE wake_up_queue
+
+#include <boost/test/included/unit_test.hpp>
+
+#include <algorithm>
+#include <map>
+#include <random>
+
+#include <esl/simulation/wake_up_queue.hpp>
+
+using namespace esl;
+using namespace esl::simulation;
+
+
+BOOST_AUTO_TEST_SUITE(ESL)
+
+    BOOST_AUTO_TEST_CASE(wake_up_queue_basic)
+    {
+        wake_up_queue queue_;
+        BOOST_CHECK(queue_.empty());
+
+        identity<agent> a_{1}, b_{2}, c_{3};
+        queue_.set(a_, 10);
+        queue_.set(b_, 5);
+        queue_.set(c_, 7);
+        BOOST_CHECK_EQUAL(queue_.size(), 3);
+        BOOST_CHECK_EQUAL(queue_.top(), 5);
+
+        // lowering never delays an agent
+        queue_.decrease(b_, 8);
+        BOOST_CHECK_EQUAL(*queue_.find(b_), 5);
+        queue_.decrease(a_, 3);
+        BOOST_CHECK_EQUAL(queue_.top(), 3);
+
+        queue_.set(a_, 12);
+        BOOST_CHECK_EQUAL(queue_.top(), 5);
+
+        std::vector<identity<agent>> due_;
+        queue_.due(7, [&](const identity<agent> &i, time_point){
+            due_.push_back(i);
+        });
+        std::sort(due_.begin(), due_.end());
+        BOOST_CHECK(due_ == (std::vector<identity<agent>>{b_, c_}));
+
+        queue_.erase(b_);
+        BOOST_CHECK(!queue_.contains(b_));
+        BOOST_CHECK_EQUAL(queue_.top(), 7);
+
+        // an erased agent can be scheduled again
+        queue_.decrease(b_, 9);
+        BOOST_CHECK_EQUAL(*queue_.find(b_), 9);
+        BOOST_CHECK_EQUAL(queue_.size(), 3);
+    }
+
+    BOOST_AUTO_TEST_CASE(wake_up_queue_random)
+    {
+        wake_up_queue queue_;
+        std::map<identity<agent>, time_point> expected_;
+        std::mt19937_64 generator_(42);
+
+        for(unsigned int k = 0; k < 20'000; ++k){
+            identity<agent> a_{std::uint64_t(generator_() % 200)};
+            time_point t_ = generator_() % 1'000;
+            switch(generator_() % 4){
+            case 0:
+                queue_.erase(a_);
+                expected_.erase(a_);
+                break;
+            case 1:
+                queue_.decrease(a_, t_);
+                if(expected_.end() == expected_.find(a_)){
+                    expected_[a_] = t_;
+                }else{
+                    expected_[a_] = std::min(expected_[a_], t_);
+                }
+                break;
+            default:
+                queue_.set(a_, t_);
+                expected_[a_] = t_;
+            }
+
+            BOOST_REQUIRE_EQUAL(queue_.size(), expected_.size());
+            if(expected_.empty()){
+                continue;
+            }
+            auto first_ = std::min_element(expected_.begin(), expected_.end(), [](const auto &x, const auto &y){
+                return x.second < y.second;
+            });
+            BOOST_REQUIRE_EQUAL(queue_.top(), first_->second);
+            BOOST_REQUIRE_EQUAL(queue_.contains(a_), 1 == expected_.count(a_));
+            if(queue_.contains(a_)){
+                BOOST_REQUIRE_EQUAL(*queue_.find(a_), expected_[a_]);
+            }
+
+            std::size_t due_ = 0;
+            queue_.due(t_, [&](const identity<agent> &i, time_point t){
+                BOOST_REQUIRE_LE(t, t_);
+                BOOST_REQUIRE_EQUAL(expected_[i], t);
+                ++due_;
+            });
+            BOOST_REQUIRE_EQUAL(due_, std::count_if(expected_.begin(), expected_.end(), [&](const auto &x){
+                return x.second <= t_;
+            }));
+        }
+    }
+
+BOOST_AUTO_TEST_SUITE_END()  // ESL